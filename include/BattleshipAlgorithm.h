@@ -1,38 +1,147 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include <utility>
 
+class EndgameSolver;
 class GameBoard;
+class MoveTraceBuffer;
+class OpeningBook;
+class ThreadPool;
+
+// Константы эвристик алгоритма; значения по умолчанию — исходные
+struct AlgorithmParams {
+    double lambdaMax = 2.0;          // максимальный коэффициент риска
+    double riskExponent = -3.0;      // lambda = lambdaMax * exp(riskExponent * L / Lmax)
+    double neighborPenalty = 0.1;    // штраф за каждую непустую клетку в окрестности 3x3
+    double shipFactor = 0.7;         // рост вероятности корабля вокруг попадания
+    double mineFactor = 0.3;         // рост вероятности мины вокруг подрыва
+    double mineThreshold = 0.5;      // допустимая сумма вероятностей мин на палубу при малом числе жизней
+    int lowLives = 2;                // с этого числа жизней включается осторожный режим
+};
+
+// Отпечаток параметров: офлайн-данные (дебютная книга) помнят, под какие параметры
+// построены. Равные параметры дают равный хеш на любой платформе.
+std::uint64_t hashParams(const AlgorithmParams& params);
+
+// Этап выбора хода: от дешёвого запасного хода до полного перебора поля
+enum class SearchStage {
+    None,        // ход не выбирался
+    Fallback,    // первая непростреленная клетка
+    Kill,        // добивание раненого корабля
+    LastHit,     // соседи последнего попадания
+    Candidates,  // окна под самый длинный корабль
+    Pattern,     // шаблон квадратов
+    FullBoard,   // полезность по всему полю
+    Endgame,     // точный перебор оставшихся расстановок
+    Book         // ход из дебютной книги
+};
+
+// Отчёт о выборе последнего хода
+struct MoveReport {
+    SearchStage stage = SearchStage::None;  // последний пройденный этап
+    bool complete = false;                  // ход совпадает с выбором без ограничения времени
+    int evaluatedCells = 0;                 // сколько клеток и окон оценено
+    double searchMicros = 0.0;              // время выбора клетки (на него рассчитан бюджет)
+    double elapsedMicros = 0.0;             // время всего makeMove: выбор, выстрел, пересчёт вероятностей
+};
 
 class BattleshipAlgorithm {
 public:
+    // Версия выбора хода: повышается, когда при тех же параметрах меняются ходы,
+    // чтобы книги, построенные прежним движком, не подключались
+    static const std::uint32_t kEngineVersion = 1;
+
     // Конструктор
-    BattleshipAlgorithm(std::shared_ptr<GameBoard> board, int maxLives);
+    BattleshipAlgorithm(std::shared_ptr<GameBoard> board, int maxLives,
+                        const AlgorithmParams& params = AlgorithmParams());
+    
+    // Новая партия на том же поле: поле уже расставлено заново (applyLayout).
+    // Память алгоритма переиспользуется; трассировка, пул, solver и книга сохраняются.
+    // Бросает std::invalid_argument, если подключённая книга построена под другое число жизней.
+    void reset(int maxLives);
     
     // Основные методы
     bool makeMove();
+    // Ход с жёстким бюджетом: уточняет выбор этап за этапом, пока не наступит deadline,
+    // и стреляет в лучшую найденную к этому моменту клетку
+    bool makeMove(std::chrono::steady_clock::time_point deadline);
     int getCurrentLives() const;
     
     // Геттеры
     double getCurrentLambda() const;
+    const AlgorithmParams& getParams() const;
+    // Клетка, по которой был сделан последний выстрел ({-1, -1}, если хода не было)
+    std::pair<int, int> getLastMove() const;
+    const MoveReport& getLastReport() const;
+    
+    // Трассировка: перед каждым выстрелом в trace пишется кадр с вероятностями,
+    // состоянием поля и выбранной клеткой (nullptr — выключено)
+    void setTrace(MoveTraceBuffer* trace, std::uint32_t gameId = 0);
+    
+    // Параллельная оценка клеток внутри хода на полях от minBoardSize и больше.
+    // Результат совпадает с последовательным; nullptr — выключено.
+    static const int kDefaultParallelMinSize = 50;
+    void setThreadPool(ThreadPool* pool, int minBoardSize = kDefaultParallelMinSize);
+    
+    // Точный эндшпиль: пока согласных расстановок больше порога solver, ходы выбирают
+    // эвристики, потом — solver. Один solver на алгоритм; nullptr — выключено.
+    void setEndgameSolver(EndgameSolver* solver);
+    
+    // Дебютная книга: первые book->depth() ходов берутся из неё, если история
+    // наблюдений там есть. Книга только читается, её можно делить между алгоритмами.
+    // Задаётся до первого хода. Бросает std::invalid_argument, если книга построена
+    // для другого размера поля, числа жизней или других параметров.
+    void setOpeningBook(const OpeningBook* book);
 
 private:
+    struct SearchBudget;
+    
     // Вспомогательные методы
+    bool playMove(SearchBudget& budget);
     void initializeProbabilities();
     double calculateRiskCoefficient() const;
     double calculateUtility(int x, int y) const;
-    std::pair<int, int> findBestMove();
+    std::pair<int, int> findBestMove(SearchBudget& budget);
+    std::pair<int, int> findFallbackMove();
+    ThreadPool* parallelPool() const;
     std::pair<int, int> findKillMove();
     void updateProbabilities(int x, int y, bool hitShip, bool hitMine);
+    // Вывод из правил расстановки после выстрела: корабли не касаются друг друга,
+    // мины не стоят рядом с кораблями. sunkCells — клетки потопленного этим выстрелом корабля
+    void propagateConstraints(int x, int y, bool hitShip, bool hitMine,
+                              const std::vector<std::pair<int, int>>& sunkCells);
+    // Клетка не прострелена и корабля в ней быть может
+    bool isHuntable(int x, int y) const;
     
     // Состояние алгоритма
     std::shared_ptr<GameBoard> board_;
+    AlgorithmParams params_;
+    double neighborPenalties_[10];  // штраф для 0..9 непустых клеток в окрестности
     int maxLives_;
     int currentLives_;
     bool hasLastHit;
     int lastHitX;
     int lastHitY;
     std::vector<std::pair<int, int>> woundedCells_;
+    // Клетки (y * size + x), где по правилам не может быть корабля или мины
+    std::vector<unsigned char> noShip_;
+    std::vector<unsigned char> noMine_;
+    std::pair<int, int> lastMove_;
+    MoveTraceBuffer* trace_;
+    std::uint32_t traceGame_;
+    std::uint32_t moveIndex_;
+    MoveReport report_;
+    int fallbackCursor_;
+    ThreadPool* pool_;
+    int parallelMinSize_;
+    EndgameSolver* endgame_;
+    const OpeningBook* book_;
+    std::uint64_t historyKey_;  // ключ истории наблюдений для книги
+    // Клетки шаблона квадратов для n = 3 и n = 4 (для остальных длин шаблон пуст)
+    std::vector<std::pair<int, int>> pattern3_;
+    std::vector<std::pair<int, int>> pattern4_;
 }; 
\ No newline at end of file
@@ -0,0 +1,109 @@
+#pragma once
+
+/*
+ * Стабильный C ABI движка (libbattleship).
+ *
+ * Все массивы выделяет и освобождает вызывающая сторона; библиотека только
+ * читает и пишет в переданные буферы. Сетки — построчно (row-major), индекс y * size + x.
+ * Функции не бросают исключений: ошибки возвращаются отрицательными кодами.
+ * Подходит для ctypes без сборочной зависимости от Python.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(BATTLESHIP_BUILD_SHARED)
+#    define BS_API __declspec(dllexport)
+#  else
+#    define BS_API __declspec(dllimport)
+#  endif
+#else
+#  define BS_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BS_ABI_VERSION 1
+
+/* Коды возврата */
+#define BS_OK 0
+#define BS_GAME_OVER 1
+#define BS_ERROR_ARGUMENT (-1)
+#define BS_ERROR_LAYOUT (-2)
+#define BS_ERROR_BUFFER (-3)
+#define BS_ERROR_INTERNAL (-4)
+
+/* Исходы выстрела (совпадают с ShotOutcome) */
+#define BS_MISS 0
+#define BS_HIT 1
+#define BS_MINE 2
+#define BS_SUNK 3
+
+typedef struct bs_game bs_game;
+
+typedef struct {
+    int32_t x;
+    int32_t y;
+    int32_t length;
+    int32_t horizontal;
+} bs_ship;
+
+typedef struct {
+    int32_t x;
+    int32_t y;
+} bs_cell;
+
+typedef struct {
+    int32_t x;
+    int32_t y;
+    int32_t outcome;
+} bs_move;
+
+typedef struct {
+    uint64_t seed;
+    int32_t moves;
+    int32_t lives_left;
+    int32_t victory;
+    int32_t status; /* BS_OK, BS_ERROR_LAYOUT (расстановка не сгенерирована) или BS_ERROR_INTERNAL */
+} bs_game_result;
+
+BS_API int32_t bs_abi_version(void);
+
+/* Игра с пустым полем size x size; NULL при неверных аргументах (size < 1, max_lives < 1) */
+BS_API bs_game* bs_game_create(int32_t size, int32_t max_lives);
+BS_API void bs_game_destroy(bs_game* game);
+
+/*
+ * Расставляет корабли и мины по правилам и начинает партию заново.
+ * BS_ERROR_LAYOUT — поле вне доски, длина < 1, horizontal не 0/1 или нарушены правила.
+ */
+BS_API int32_t bs_game_load_layout(bs_game* game,
+                                   const bs_ship* ships, size_t ship_count,
+                                   const bs_cell* mines, size_t mine_count);
+
+/* Один ход алгоритма; BS_GAME_OVER, если партия уже закончена или ходов нет */
+BS_API int32_t bs_game_step(bs_game* game, bs_move* move);
+
+BS_API int32_t bs_game_size(const bs_game* game);
+BS_API int32_t bs_game_lives(const bs_game* game);
+BS_API int32_t bs_game_remaining_ships(const bs_game* game);
+BS_API int32_t bs_game_is_over(const bs_game* game);
+
+/* Копируют сетки в буфер вызывающего; count — число элементов, не меньше size * size */
+BS_API int32_t bs_game_read_ship_probabilities(const bs_game* game, double* out, size_t count);
+BS_API int32_t bs_game_read_mine_probabilities(const bs_game* game, double* out, size_t count);
+BS_API int32_t bs_game_read_cells(const bs_game* game, int8_t* out, size_t count);
+
+/*
+ * Играет count партий на случайных расстановках из seeds[i] в threads потоках
+ * (0 — по числу ядер) и пишет итоги в results[i].
+ */
+BS_API int32_t bs_run_games(int32_t size, const uint64_t* seeds, size_t count,
+                            int32_t threads, bs_game_result* results);
+
+#ifdef __cplusplus
+}
+#endif
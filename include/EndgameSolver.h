@@ -0,0 +1,126 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class GameBoard;
+
+// Точный эндшпиль: перебирает все расстановки непотопленных кораблей, согласные
+// с тем, что видно игроку (промахи, попадания, мины, потопленные корабли), и
+// выбирает выстрел с минимальным ожидаемым числом оставшихся выстрелов.
+// Мины не перебираются: при расстановке кораблей они равновероятно лежат в
+// свободных клетках, поэтому вес расстановки — C(свободные клетки, мины).
+// Подрыв на последней жизни стоит size * size выстрелов, так что риск берётся
+// только если иначе нельзя.
+// Клетки поля хранятся битовыми масками, подзадачи кешируются.
+// Перебор запускается только в эндшпиле: непотопленных кораблей не больше maxShips
+// и клеток без информации не больше maxUnknown. Положения кораблей кешируются между
+// вызовами и только прореживаются по мере того, как клетки открываются.
+//
+// Solver выключен, пока его не передали в BattleshipAlgorithm::setEndgameSolver, и
+// без deadline ограничен только nodeBudget. Замер на 2000 партиях 10x10 без бюджета
+// (battleship_latency --endgame-layouts L --endgame-nodes K): без solver p99 хода 14 мкс,
+// с порогами по умолчанию — p99 6.4 мс, максимум 24 мс; при L = 100, K = 300 —
+// p99 0.7 мс. Ни в одной настройке ни выживаемость (0.63–0.65), ни среднее число
+// ходов (52.5–52.7) не изменились за пределами шума, поэтому по умолчанию он не включён.
+class EndgameSolver {
+public:
+    static const int kDefaultMaxLayouts = 100;
+    static const int kDefaultNodeBudget = 2000;
+    static const int kDefaultMaxShips = 3;
+    static const int kDefaultMaxUnknown = 100;
+
+    // Отчёт о последнем вызове findMove
+    struct Stats {
+        int layouts = 0;              // согласных расстановок (maxLayouts + 1 — перебор прерван)
+        int nodes = 0;                // развёрнуто узлов перебора
+        bool solved = false;          // ход найден точно
+        bool skipped = false;         // ещё не эндшпиль, перебор не запускался
+        bool timedOut = false;        // перебор прерван по сроку
+        double expectedShots = 0.0;   // ожидаемое число оставшихся выстрелов
+    };
+
+    // maxLayouts — порог включения, nodeBudget — жёсткий предел узлов на ход,
+    // maxShips и maxUnknown — дешёвая проверка эндшпиля перед перебором
+    EndgameSolver(int maxLayouts = kDefaultMaxLayouts, int nodeBudget = kDefaultNodeBudget,
+                  int maxShips = kDefaultMaxShips, int maxUnknown = kDefaultMaxUnknown);
+
+    // Лучший выстрел или {-1, -1}, если ещё не эндшпиль, расстановок больше порога,
+    // не хватило узлов или наступил deadline
+    std::pair<int, int> findMove(const GameBoard& board, int lives,
+                                 std::chrono::steady_clock::time_point deadline =
+                                     std::chrono::steady_clock::time_point::max());
+
+    const Stats& getLastStats() const;
+
+private:
+    struct Entry {
+        int layout;  // индекс расстановки
+        int free;    // непростреленных клеток, где может лежать мина
+    };
+    struct Memo {
+        double value;
+        int cell;
+    };
+    static const int kDeadlineInterval = 64;
+
+    struct KeyHash {
+        std::size_t operator()(const std::vector<std::uint64_t>& key) const;
+    };
+
+    bool setup(const GameBoard& board);
+    void updatePlacements(const GameBoard& board);
+    void buildPlacements();
+    bool expired();
+    void enumerate(std::size_t ship, int minPlacement);
+    double solve(const std::vector<Entry>& entries, int minesHit, int lives, int hitsLeft, int& bestCell);
+
+    bool test(const std::uint64_t* mask, int cell) const;
+    void set(std::uint64_t* mask, int cell) const;
+    void clear(std::uint64_t* mask, int cell) const;
+    double weight(const Entry& entry, int minesHit) const;
+
+    int maxLayouts_;
+    int nodeBudget_;
+    int maxShips_;
+    int maxUnknown_;
+    Stats stats_;
+    std::chrono::steady_clock::time_point deadline_;
+
+    // Поле на момент вызова
+    int size_;
+    int words_;
+    int mines_;                                // неподорванных мин
+    std::vector<std::uint64_t> unknown_;       // клетки без информации
+    std::vector<std::uint64_t> wounded_;       // попадания по непотопленным кораблям
+    std::vector<std::uint64_t> blocked_;       // клетки, где корабля быть не может (рядом с миной)
+    std::vector<int> lengths_;                 // непотопленные корабли, по убыванию длины
+
+    // Положения кораблей: клетки и клетки вместе с окрестностью. Кеш живёт между
+    // вызовами, пока поле то же: excluded_ — клетки, уже исключённые из положений
+    const GameBoard* cachedBoard_;
+    int cachedSize_;
+    std::vector<int> cachedLengths_;
+    std::vector<std::uint64_t> excluded_;
+    std::vector<int> placementLength_;
+    std::vector<std::uint64_t> placementCells_;
+    std::vector<std::uint64_t> placementHalo_;
+
+    // Согласные расстановки
+    std::vector<std::uint64_t> layoutCells_;
+    std::vector<std::uint64_t> layoutHalo_;
+    std::vector<int> layoutShips_;             // индексы положений, lengths_.size() на расстановку
+    std::vector<int> layoutFree_;
+    std::vector<std::uint64_t> enumerateStack_;  // клетки и окрестность на каждой глубине
+    std::vector<int> chosen_;
+    int enumerateNodes_;
+    bool aborted_;
+
+    // Клетки, подбитые внутри перебора
+    std::vector<std::uint64_t> hits_;
+    std::unordered_map<std::vector<std::uint64_t>, Memo, KeyHash> memo_;
+};
@@ -0,0 +1,380 @@
+#pragma once
+
+#include "BattleshipAlgorithm.h"
+#include "FixedGameBoard.h"
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+// Шаблон квадратов (getSquarePattern) для длины n на поле N x N, в порядке обхода
+// std::set<std::pair<int, int>>: по x, затем по y
+template <int N>
+struct FixedPattern {
+    std::array<std::int16_t, N * N> cells{};
+    int count = 0;
+};
+
+template <int N>
+constexpr FixedPattern<N> makeFixedPattern(int n) {
+    std::array<bool, N * N> mask{};
+    if (n == 3 || n == 4) {
+        for (int y0 = 0; y0 < N; y0 += n) {
+            for (int x0 = 0; x0 < N; x0 += n) {
+                for (int i = 0; i < n; ++i) {
+                    if (x0 + i < N && y0 + i < N) mask[(y0 + i) * N + x0 + i] = true;
+                    if (n == 4 && x0 + n - 1 - i < N && y0 + i < N) mask[(y0 + i) * N + x0 + n - 1 - i] = true;
+                }
+            }
+        }
+    }
+    FixedPattern<N> pattern{};
+    for (int x = 0; x < N; ++x) {
+        for (int y = 0; y < N; ++y) {
+            if (mask[y * N + x]) pattern.cells[pattern.count++] = static_cast<std::int16_t>(y * N + x);
+        }
+    }
+    return pattern;
+}
+
+// BattleshipAlgorithm для поля фиксированного размера.
+// Повторяет выбор хода BattleshipAlgorithm без ограничения времени (makeMove()) —
+// партии совпадают ход в ход; трассировка, бюджет, пул потоков и эндшпиль здесь не поддерживаются.
+template <int N>
+class FixedBattleshipAlgorithm {
+public:
+    using Board = FixedGameBoard<N>;
+    static constexpr int kCells = N * N;
+
+    FixedBattleshipAlgorithm(Board& board, int maxLives, const AlgorithmParams& params = AlgorithmParams())
+        : board_(board), params_(params), maxLives_(maxLives), currentLives_(maxLives),
+          hasLastHit_(false), lastHitX_(0), lastHitY_(0), woundedCount_(0), lastMove_(-1, -1),
+          lastStage_(SearchStage::None), unshotCursor_(0), noShip_{}, noMine_{} {
+        neighborPenalties_[0] = 0.0;
+        for (int k = 1; k < 10; ++k) {
+            neighborPenalties_[k] = neighborPenalties_[k - 1] + params_.neighborPenalty;
+        }
+        initializeProbabilities();
+    }
+
+    bool makeMove() {
+        lastMove_ = {-1, -1};
+        lastStage_ = SearchStage::None;
+        if (currentLives_ <= 0) return false;
+
+        auto [x, y] = findBestMove();
+        if (x == -1 || y == -1) return false;  // Нет доступных ходов
+        lastMove_ = {x, y};
+
+        bool hit = board_.makeShot(x, y);
+        if (hit) {
+            hasLastHit_ = true;
+            lastHitX_ = x;
+            lastHitY_ = y;
+            int index = y * N + x;
+            bool alreadyWounded = false;
+            for (int i = 0; i < woundedCount_; ++i) {
+                if (wounded_[i] == index) {
+                    alreadyWounded = true;
+                    break;
+                }
+            }
+            if (!alreadyWounded) wounded_[woundedCount_++] = static_cast<std::int16_t>(index);
+            updateProbabilities(x, y, true, false);
+            // Потопленный корабль уходит из раненых целиком, порядок остальных сохраняется
+            std::array<std::int16_t, kCells> sunk;
+            int sunkCount = 0;
+            if (board_.isSunkAt(x, y)) {
+                int kept = 0;
+                for (int i = 0; i < woundedCount_; ++i) {
+                    int cell = wounded_[i];
+                    if (!board_.isSunkAt(cell % N, cell / N)) wounded_[kept++] = wounded_[i];
+                    else sunk[sunkCount++] = wounded_[i];
+                }
+                woundedCount_ = kept;
+            }
+            propagateConstraints(x, y, true, false, sunk.data(), sunkCount);
+        } else if (board_.cell(x, y) == 4) {  // Попали в мину
+            currentLives_--;
+            updateProbabilities(x, y, false, true);
+            propagateConstraints(x, y, false, true, nullptr, 0);
+        } else {
+            updateProbabilities(x, y, false, false);
+            propagateConstraints(x, y, false, false, nullptr, 0);
+        }
+        return hit;
+    }
+
+    int getCurrentLives() const { return currentLives_; }
+    std::pair<int, int> getLastMove() const { return lastMove_; }
+    // Этап, выбравший последний ход (как MoveReport::stage у BattleshipAlgorithm)
+    SearchStage getLastStage() const { return lastStage_; }
+
+private:
+    static constexpr int kDirections[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+
+    void initializeProbabilities() {
+        int totalShips = static_cast<int>(std::floor(0.2 * N * N));
+        int totalMines = static_cast<int>(std::floor(0.03 * N * N));
+        board_.setInitialProbabilities(static_cast<double>(totalShips) / (N * N),
+                                       static_cast<double>(totalMines) / (N * N));
+    }
+
+    double calculateRiskCoefficient() const {
+        double lifeRatio = static_cast<double>(currentLives_) / maxLives_;
+        return params_.lambdaMax * std::exp(params_.riskExponent * lifeRatio);
+    }
+
+    double calculateUtility(int x, int y) const {
+        double lambda = calculateRiskCoefficient();
+        return board_.shipProbability(x, y) - lambda * board_.mineProbability(x, y)
+               - neighborPenalties_[board_.neighborCount(x, y)];
+    }
+
+    // Клетка не прострелена и корабля в ней быть может
+    bool isHuntable(int x, int y) const {
+        return !board_.isShot(x, y) && !noShip_[y * N + x];
+    }
+
+    void consider(int x, int y, double& bestUtility, std::pair<int, int>& bestMove) const {
+        if (Board::isValidPosition(x, y) && isHuntable(x, y)) {
+            double utility = calculateUtility(x, y);
+            if (utility > bestUtility) {
+                bestUtility = utility;
+                bestMove = {x, y};
+            }
+        }
+    }
+
+    std::pair<int, int> findKillMove() const {
+        double bestUtility = -std::numeric_limits<double>::infinity();
+        std::pair<int, int> bestMove = {-1, -1};
+        bool isVertical = woundedCount_ > 1, isHorizontal = woundedCount_ > 1;
+        int x0 = wounded_[0] % N, y0 = wounded_[0] / N;
+        for (int i = 0; i < woundedCount_ && woundedCount_ > 1; ++i) {
+            if (wounded_[i] % N != x0) isVertical = false;
+            if (wounded_[i] / N != y0) isHorizontal = false;
+        }
+        if (isVertical) {
+            // Добиваем только вверх и вниз
+            int minY = N, maxY = -1;
+            for (int i = 0; i < woundedCount_; ++i) {
+                minY = std::min(minY, wounded_[i] / N);
+                maxY = std::max(maxY, wounded_[i] / N);
+            }
+            consider(x0, minY - 1, bestUtility, bestMove);
+            consider(x0, maxY + 1, bestUtility, bestMove);
+        } else if (isHorizontal) {
+            // Добиваем только влево и вправо
+            int minX = N, maxX = -1;
+            for (int i = 0; i < woundedCount_; ++i) {
+                minX = std::min(minX, wounded_[i] % N);
+                maxX = std::max(maxX, wounded_[i] % N);
+            }
+            consider(minX - 1, y0, bestUtility, bestMove);
+            consider(maxX + 1, y0, bestUtility, bestMove);
+        } else {
+            for (int i = 0; i < woundedCount_; ++i) {
+                for (const auto& dir : kDirections) {
+                    consider(wounded_[i] % N + dir[0], wounded_[i] / N + dir[1], bestUtility, bestMove);
+                }
+            }
+        }
+        return bestMove;
+    }
+
+    bool hasUnshotCell() {
+        // Клетки только простреливаются, поэтому курсор двигается лишь вперёд
+        while (unshotCursor_ < kCells && board_.isShot(unshotCursor_ % N, unshotCursor_ / N)) unshotCursor_++;
+        return unshotCursor_ < kCells;
+    }
+
+    std::pair<int, int> findBestMove() {
+        lastStage_ = SearchStage::Fallback;
+        if (!hasUnshotCell()) return {-1, -1};
+        double bestUtility = -std::numeric_limits<double>::infinity();
+        std::pair<int, int> bestMove = {-1, -1};
+        if (woundedCount_ > 0) {
+            lastStage_ = SearchStage::Kill;
+            auto move = findKillMove();
+            if (move.first != -1) return move;
+        }
+        int n = board_.getMaxAliveShipLength();
+        if (hasLastHit_) {
+            lastStage_ = SearchStage::LastHit;
+            for (const auto& dir : kDirections) {
+                consider(lastHitX_ + dir[0], lastHitY_ + dir[1], bestUtility, bestMove);
+            }
+        }
+        if (bestMove.first == -1) {
+            lastStage_ = SearchStage::Candidates;
+            // Окна под самый длинный корабль: кандидаты перебираются в том же порядке,
+            // что строит findMaxShipCandidates, но без промежуточного списка
+            double minMineSum = 1e9;
+            std::pair<int, int> safestCell = {-1, -1};
+            auto evaluate = [&](int x, int y) {
+                double mineSumH = 0.0, mineSumV = 0.0;
+                bool validH = true, validV = true;
+                for (int d = 0; d < n; ++d) {
+                    if (x + d >= N || !isHuntable(x + d, y)) { validH = false; break; }
+                    mineSumH += board_.mineProbability(x + d, y);
+                }
+                for (int d = 0; d < n; ++d) {
+                    if (y + d >= N || !isHuntable(x, y + d)) { validV = false; break; }
+                    mineSumV += board_.mineProbability(x, y + d);
+                }
+                if (validH && mineSumH < minMineSum) {
+                    minMineSum = mineSumH;
+                    safestCell = {x + n/2, y};
+                }
+                if (validV && mineSumV < minMineSum) {
+                    minMineSum = mineSumV;
+                    safestCell = {x, y + n/2};
+                }
+            };
+            for (int y = 0; y < N; ++y) {
+                int streak = 0;
+                for (int x = 0; x < N; ++x) {
+                    streak = isHuntable(x, y) ? streak + 1 : 0;
+                    if (streak >= n && streak >= n / 2 + 1) evaluate(x - n / 2, y);
+                }
+            }
+            for (int x = 0; x < N; ++x) {
+                int streak = 0;
+                for (int y = 0; y < N; ++y) {
+                    streak = isHuntable(x, y) ? streak + 1 : 0;
+                    if (streak >= n && streak >= n / 2 + 1) evaluate(x, y - n / 2);
+                }
+            }
+            double mineThreshold = params_.mineThreshold * n;
+            if (!(currentLives_ <= params_.lowLives && minMineSum > mineThreshold) && safestCell.first != -1) {
+                bestMove = safestCell;
+            }
+        }
+        if (bestMove.first == -1) lastStage_ = SearchStage::Pattern;
+        if (bestMove.first == -1 && (n == 3 || n == 4)) {
+            const auto& pattern = n == 3 ? kPattern3 : kPattern4;
+            for (int i = 0; i < pattern.count; ++i) {
+                consider(pattern.cells[i] % N, pattern.cells[i] / N, bestUtility, bestMove);
+            }
+        }
+        if (bestMove.first == -1) {
+            lastStage_ = SearchStage::FullBoard;
+            for (int y = 0; y < N; ++y) {
+                for (int x = 0; x < N; ++x) {
+                    consider(x, y, bestUtility, bestMove);
+                }
+            }
+        }
+        return bestMove;
+    }
+
+    void updateProbabilities(int x, int y, bool hitShip, bool hitMine) {
+        board_.updateProbabilities(x, y, hitShip, hitMine);
+        for (int dx = -2; dx <= 2; ++dx) {
+            for (int dy = -2; dy <= 2; ++dy) {
+                int nx = x + dx;
+                int ny = y + dy;
+                if (Board::isValidPosition(nx, ny)) {
+                    double distance = std::sqrt(dx*dx + dy*dy);
+                    if (distance <= 2.0) {
+                        double factor = std::exp(-distance);
+                        if (hitShip && ((dx == 0 && dy != 0) || (dx != 0 && dy == 0))) {
+                            board_.updateProbabilities(nx, ny, false, false, factor * params_.shipFactor);
+                        }
+                        if (hitMine) {
+                            board_.updateProbabilities(nx, ny, false, false, 0.0, factor * params_.mineFactor);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Как BattleshipAlgorithm::propagateConstraints; sunk — клетки потопленного этим выстрелом корабля
+    void propagateConstraints(int x, int y, bool hitShip, bool hitMine, const std::int16_t* sunk, int sunkCount) {
+        auto forNeighbors = [](int cx, int cy, auto&& fn) {
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    int nx = cx + dx, ny = cy + dy;
+                    if ((dx != 0 || dy != 0) && Board::isValidPosition(nx, ny)) fn(ny * N + nx, dx != 0 && dy != 0);
+                }
+            }
+        };
+        if (hitShip) {
+            forNeighbors(x, y, [&](int index, bool diagonal) {
+                noMine_[index] = true;
+                if (diagonal) noShip_[index] = true;
+            });
+        }
+        if (hitMine) {
+            forNeighbors(x, y, [&](int index, bool) { noShip_[index] = true; });
+        }
+        for (int i = 0; i < sunkCount; ++i) {
+            forNeighbors(sunk[i] % N, sunk[i] / N, [&](int index, bool) {
+                noShip_[index] = true;
+                noMine_[index] = true;
+            });
+        }
+
+        // Нули восстанавливаются в окне разлёта updateProbabilities и вокруг потопленного корабля
+        const int kSpreadRadius = 4;
+        auto restore = [&](int index, bool) {
+            int cx = index % N, cy = index / N;
+            if (board_.isShot(cx, cy)) return;
+            if (noShip_[index]) board_.setShipProbability(cx, cy, 0.0);
+            if (noMine_[index]) board_.setMineProbability(cx, cy, 0.0);
+        };
+        for (int cy = std::max(0, y - kSpreadRadius); cy <= std::min(N - 1, y + kSpreadRadius); ++cy) {
+            for (int cx = std::max(0, x - kSpreadRadius); cx <= std::min(N - 1, x + kSpreadRadius); ++cx) {
+                restore(cy * N + cx, false);
+            }
+        }
+        for (int i = 0; i < sunkCount; ++i) forNeighbors(sunk[i] % N, sunk[i] / N, restore);
+
+        if (woundedCount_ == 0) return;
+        int minX = N, maxX = -1, minY = N, maxY = -1;
+        for (int i = 0; i < woundedCount_; ++i) {
+            minX = std::min(minX, wounded_[i] % N);
+            maxX = std::max(maxX, wounded_[i] % N);
+            minY = std::min(minY, wounded_[i] / N);
+            maxY = std::max(maxY, wounded_[i] / N);
+        }
+        bool horizontal = minY == maxY && maxX - minX + 1 == woundedCount_;
+        bool vertical = minX == maxX && maxY - minY + 1 == woundedCount_;
+        if (!horizontal && !vertical) return;
+        const int ends[4][2] = {{minX - 1, minY}, {maxX + 1, minY}, {minX, minY - 1}, {minX, maxY + 1}};
+        int options = 0;
+        int forcedX = -1, forcedY = -1;
+        for (int i = 0; i < 4; ++i) {
+            if (woundedCount_ > 1 && (i < 2) != horizontal) continue;
+            if (Board::isValidPosition(ends[i][0], ends[i][1]) && isHuntable(ends[i][0], ends[i][1])) {
+                options++;
+                forcedX = ends[i][0];
+                forcedY = ends[i][1];
+            }
+        }
+        if (options == 1) board_.setShipProbability(forcedX, forcedY, 1.0);
+    }
+
+    static constexpr FixedPattern<N> kPattern3 = makeFixedPattern<N>(3);
+    static constexpr FixedPattern<N> kPattern4 = makeFixedPattern<N>(4);
+
+    Board& board_;
+    AlgorithmParams params_;
+    double neighborPenalties_[10];
+    int maxLives_;
+    int currentLives_;
+    bool hasLastHit_;
+    int lastHitX_;
+    int lastHitY_;
+    std::array<std::int16_t, kCells> wounded_;
+    int woundedCount_;
+    std::pair<int, int> lastMove_;
+    SearchStage lastStage_;
+    int unshotCursor_;
+    // Клетки, где по правилам не может быть корабля или мины
+    std::array<bool, kCells> noShip_;
+    std::array<bool, kCells> noMine_;
+};
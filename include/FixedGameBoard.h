@@ -0,0 +1,263 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+// Поле фиксированного размера N x N, известного при компиляции.
+// Повторяет правила и коды клеток GameBoard, но хранит всё во встроенных
+// std::array (без кучи), а окрестности клеток берёт из constexpr-таблиц.
+// Используется FixedBattleshipAlgorithm<N>; партии совпадают с GameBoard ход в ход.
+
+template <int N>
+struct FixedNeighborTable {
+    // Клетки окрестности 3x3 (включая саму клетку), обрезанные границей поля
+    std::array<std::array<std::int16_t, 9>, N * N> cells{};
+    std::array<std::int8_t, N * N> count{};
+};
+
+template <int N>
+constexpr FixedNeighborTable<N> makeFixedNeighborTable() {
+    FixedNeighborTable<N> table{};
+    for (int y = 0; y < N; ++y) {
+        for (int x = 0; x < N; ++x) {
+            int index = y * N + x;
+            int count = 0;
+            for (int ny = y - 1; ny <= y + 1; ++ny) {
+                for (int nx = x - 1; nx <= x + 1; ++nx) {
+                    if (nx >= 0 && nx < N && ny >= 0 && ny < N) {
+                        table.cells[index][count++] = static_cast<std::int16_t>(ny * N + nx);
+                    }
+                }
+            }
+            table.count[index] = static_cast<std::int8_t>(count);
+        }
+    }
+    return table;
+}
+
+template <int N>
+class FixedGameBoard {
+public:
+    static_assert(N > 0 && N * N <= 32767, "board size out of range");
+
+    static constexpr int kSize = N;
+    static constexpr int kCells = N * N;
+    // Корабли не касаются друг друга, поэтому их не больше, чем квадратов 2x2
+    static constexpr int kMaxShips = ((N + 1) / 2) * ((N + 1) / 2);
+    static constexpr FixedNeighborTable<N> kNeighbors = makeFixedNeighborTable<N>();
+
+    struct Ship {
+        int x;
+        int y;
+        int length;
+        bool horizontal;
+        int hits;
+    };
+
+    FixedGameBoard() {
+        reset();
+    }
+
+    void reset() {
+        cells_.fill(0);
+        shots_.fill(0);
+        neighborCounts_.fill(0);
+        shipAt_.fill(-1);
+        shipProbabilities_.fill(0.0);
+        mineProbabilities_.fill(0.0);
+        shipCount_ = 0;
+        remainingShips_ = 0;
+        remainingMines_ = 0;
+    }
+
+    static bool isValidPosition(int x, int y) {
+        return x >= 0 && x < N && y >= 0 && y < N;
+    }
+
+    bool canPlaceShip(int x, int y, int length, bool horizontal) const {
+        if (!isValidPosition(x, y) || length < 1) return false;
+        if (horizontal && x + length > N) return false;
+        if (!horizontal && y + length > N) return false;
+        for (int i = -1; i <= length; ++i) {
+            for (int j = -1; j <= 1; ++j) {
+                int checkX = horizontal ? x + i : x + j;
+                int checkY = horizontal ? y + j : y + i;
+                if (isValidPosition(checkX, checkY) && cells_[checkY * N + checkX] != 0) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    bool placeShip(int x, int y, int length, bool horizontal) {
+        if (shipCount_ == kMaxShips || !canPlaceShip(x, y, length, horizontal)) {
+            return false;
+        }
+        for (int i = 0; i < length; ++i) {
+            int index = horizontal ? y * N + x + i : (y + i) * N + x;
+            setCell(index, 1);
+            shipAt_[index] = static_cast<std::int16_t>(shipCount_);
+        }
+        ships_[shipCount_++] = {x, y, length, horizontal, 0};
+        remainingShips_ += length;
+        return true;
+    }
+
+    bool canPlaceMine(int x, int y) const {
+        if (!isValidPosition(x, y) || cells_[y * N + x] != 0) return false;
+        int index = y * N + x;
+        for (int k = 0; k < kNeighbors.count[index]; ++k) {
+            if (cells_[kNeighbors.cells[index][k]] == 1) return false;
+        }
+        return true;
+    }
+
+    bool placeMine(int x, int y) {
+        if (!canPlaceMine(x, y)) return false;
+        setCell(y * N + x, 2);
+        remainingMines_++;
+        return true;
+    }
+
+    bool makeShot(int x, int y) {
+        if (!isValidPosition(x, y)) return false;
+        int index = y * N + x;
+        shots_[index] = 1;
+        if (cells_[index] == 1) {
+            setCell(index, 3);  // Пораженный корабль
+            remainingShips_--;
+            Ship& ship = ships_[shipAt_[index]];
+            if (++ship.hits == ship.length) {
+                markSurroundingCells(ship);
+            }
+            return true;
+        } else if (cells_[index] == 2) {
+            setCell(index, 4);  // Сработавшая мина
+        } else if (cells_[index] == 0) {
+            setCell(index, 5);  // Промах
+        }
+        return false;
+    }
+
+    // То же, что GameBoard::updateProbabilities, в том же порядке операций
+    void updateProbabilities(int x, int y, bool hitShip, bool hitMine,
+                             double shipFactor = 0.0, double mineFactor = 0.0) {
+        int index = y * N + x;
+        shipProbabilities_[index] = hitShip ? 1.0 : 0.0;
+        mineProbabilities_[index] = (!hitShip && hitMine) ? 1.0 : 0.0;
+        if (shipFactor == 0.0 && mineFactor == 0.0) return;
+        const auto& factors = radiusFactors();
+        for (int k = 0; k < 25; ++k) {
+            if (!factors.inside[k]) continue;
+            int nx = x + factors.dx[k];
+            int ny = y + factors.dy[k];
+            if (!isValidPosition(nx, ny)) continue;
+            int neighbor = ny * N + nx;
+            double factor = factors.value[k];
+            if (shipFactor != 0.0) {
+                shipProbabilities_[neighbor] = std::max(0.0,
+                    std::min(1.0, shipProbabilities_[neighbor] + shipFactor * factor));
+            }
+            if (mineFactor != 0.0) {
+                mineProbabilities_[neighbor] = std::max(0.0,
+                    std::min(1.0, mineProbabilities_[neighbor] + mineFactor * factor));
+            }
+        }
+    }
+
+    void setShipProbability(int x, int y, double prob) { shipProbabilities_[y * N + x] = prob; }
+    void setMineProbability(int x, int y, double prob) { mineProbabilities_[y * N + x] = prob; }
+
+    void setInitialProbabilities(double shipProb, double mineProb) {
+        shipProbabilities_.fill(shipProb);
+        mineProbabilities_.fill(mineProb);
+    }
+
+    int cell(int x, int y) const { return cells_[y * N + x]; }
+    bool isShot(int x, int y) const { return shots_[y * N + x] != 0; }
+    int neighborCount(int x, int y) const { return neighborCounts_[y * N + x]; }
+    double shipProbability(int x, int y) const { return shipProbabilities_[y * N + x]; }
+    double mineProbability(int x, int y) const { return mineProbabilities_[y * N + x]; }
+
+    bool isVictory() const { return remainingShips_ == 0; }
+    int getRemainingShips() const { return remainingShips_; }
+    int getRemainingMines() const { return remainingMines_; }
+    int getShipCount() const { return shipCount_; }
+    const Ship& getShip(int i) const { return ships_[i]; }
+
+    bool isShipSunk(const Ship& ship) const { return ship.hits == ship.length; }
+
+    // Корабль в клетке уже потоплен (клетка должна принадлежать кораблю)
+    bool isSunkAt(int x, int y) const {
+        int id = shipAt_[y * N + x];
+        return id >= 0 && isShipSunk(ships_[id]);
+    }
+
+    int getMaxAliveShipLength() const {
+        int maxLen = 0;
+        for (int i = 0; i < shipCount_; ++i) {
+            if (!isShipSunk(ships_[i]) && ships_[i].length > maxLen) maxLen = ships_[i].length;
+        }
+        return maxLen;
+    }
+
+private:
+    struct RadiusFactors {
+        int dx[25];
+        int dy[25];
+        bool inside[25];
+        double value[25];
+    };
+
+    // Смещения радиуса 2 в порядке обхода GameBoard (dx снаружи, dy внутри) и exp(-расстояние)
+    static const RadiusFactors& radiusFactors() {
+        static const RadiusFactors factors = []() {
+            RadiusFactors result{};
+            int k = 0;
+            for (int dx = -2; dx <= 2; ++dx) {
+                for (int dy = -2; dy <= 2; ++dy, ++k) {
+                    double distance = std::sqrt(dx*dx + dy*dy);
+                    result.dx[k] = dx;
+                    result.dy[k] = dy;
+                    result.inside[k] = distance <= 2.0;
+                    result.value[k] = std::exp(-distance);
+                }
+            }
+            return result;
+        }();
+        return factors;
+    }
+
+    void setCell(int index, int value) {
+        int delta = (value != 0) - (cells_[index] != 0);
+        cells_[index] = static_cast<std::int8_t>(value);
+        if (delta == 0) return;
+        for (int k = 0; k < kNeighbors.count[index]; ++k) {
+            neighborCounts_[kNeighbors.cells[index][k]] += static_cast<std::int8_t>(delta);
+        }
+    }
+
+    void markSurroundingCells(const Ship& ship) {
+        for (int i = 0; i < ship.length; ++i) {
+            int index = ship.horizontal ? ship.y * N + ship.x + i : (ship.y + i) * N + ship.x;
+            for (int k = 0; k < kNeighbors.count[index]; ++k) {
+                int neighbor = kNeighbors.cells[index][k];
+                if (cells_[neighbor] == 0) setCell(neighbor, 5);  // 5 — промах/пустая клетка
+            }
+        }
+    }
+
+    std::array<std::int8_t, kCells> cells_;
+    std::array<std::int8_t, kCells> shots_;
+    std::array<std::int8_t, kCells> neighborCounts_;
+    std::array<std::int16_t, kCells> shipAt_;
+    std::array<double, kCells> shipProbabilities_;
+    std::array<double, kCells> mineProbabilities_;
+    std::array<Ship, kMaxShips> ships_;
+    int shipCount_;
+    int remainingShips_;
+    int remainingMines_;
+};
@@ -19,6 +19,9 @@ public:
     // Конструктор
     explicit GameBoard(int size);
     
+    // Сброс поля к пустому состоянию без перевыделения памяти (для повторного использования)
+    void reset();
+    
     // Основные методы
     bool placeShip(int x, int y, int length, bool horizontal);
     bool placeMine(int x, int y);
@@ -42,14 +45,25 @@ public:
     const std::vector<std::vector<int>>& getShotsBoard() const;
     const std::vector<Ship>& getShips() const;
     const std::vector<std::vector<int>>& getBoardInternal() const;
+    // Число непустых клеток в окрестности 3x3 клетки (включая её саму)
+    int getNeighborCount(int x, int y) const;
+    
+    // Отладочная проверка: счётчики соседей совпадают с пересчётом с нуля
+    bool checkNeighborCounts() const;
     
     // Управление вероятностями
     void setInitialShipProbability(double prob);
     void setInitialMineProbability(double prob);
     void updateProbabilities(int x, int y, bool hitShip, bool hitMine, 
                            double shipFactor = 0.0, double mineFactor = 0.0);
+    // Точное значение вероятности в клетке (вывод из правил расстановки)
+    void setShipProbability(int x, int y, double prob);
+    void setMineProbability(int x, int y, double prob);
     
 private:
+    // Меняет состояние клетки и поддерживает счётчики соседей
+    void setCell(int x, int y, int value);
+    
     // Размеры и состояние
     int size_;
     int remainingShips_;
@@ -57,6 +71,7 @@ private:
     
     // Игровое поле и вероятности
     std::vector<std::vector<int>> board_;
+    std::vector<std::vector<int>> neighborCounts_;
     std::vector<std::vector<double>> shipProbabilities_;
     std::vector<std::vector<double>> mineProbabilities_;
     
@@ -65,6 +80,7 @@ private:
     double initialMineProb_ = 0.0;
 
     std::vector<Ship> ships_;
+    std::vector<Ship> spareShips_;  // корабли прошлой расстановки, чтобы reset не освобождал память
 
     std::vector<std::vector<int>> shotsBoard_;
 
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "GameSetup.h"
+#include "MappedFile.h"
+#include "Simulation.h"
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Бинарный формат архива партий.
+//
+// Файл: магическое слово "BSGR", версия (uint32 LE), затем записи подряд.
+// Запись: varint длина тела, затем тело:
+//   varint size, varint seed, varint maxLives, varint livesLeft, байт флагов
+//   (бит 0 — победа, бит 1 — только расстановка: партия не сыграна, ходов и итога нет),
+//   varint shipCount, для каждого корабля varint (y*size+x) и varint (length<<1 | horizontal),
+//   varint mineCount, индексы клеток мин по возрастанию дельтами,
+//   varint moveCount, для каждого хода varint (zigzag(cell - prevCell) << 2 | outcome).
+// Все целые — беззнаковые LEB128. Версия 1 отличается только тем, что бит 1 флагов не бывает взведён.
+
+struct GameRecordHeader {
+    int size = 0;
+    std::uint64_t seed = 0;
+    int maxLives = 0;
+    int livesLeft = 0;
+    bool victory = false;
+    bool layoutOnly = false;  // расстановка без партии (battleship_layouts): livesLeft и victory не заданы
+    int shipCount = 0;
+    int mineCount = 0;
+    int moveCount = 0;
+};
+
+// Представление одной записи поверх отображённого файла; ничего не копирует
+class GameRecordView {
+public:
+    // Последовательное чтение потока ходов
+    class MoveCursor {
+    public:
+        bool next(MoveRecord& move);
+
+    private:
+        friend class GameRecordView;
+        const unsigned char* pos_ = nullptr;
+        const unsigned char* end_ = nullptr;
+        int size_ = 0;
+        int remaining_ = 0;
+        int prevCell_ = 0;
+    };
+
+    const GameRecordHeader& header() const;
+    // Заполняет layout; повторно использует его память.
+    // Бросает std::runtime_error, если расстановка в записи повреждена.
+    void readLayout(Layout& layout) const;
+    MoveCursor moves() const;
+
+private:
+    friend class GameRecordReader;
+    GameRecordHeader header_;
+    const unsigned char* ships_ = nullptr;
+    const unsigned char* mines_ = nullptr;
+    const unsigned char* moves_ = nullptr;
+    const unsigned char* end_ = nullptr;
+};
+
+// Читатель архива через отображение файла в память
+class GameRecordReader {
+public:
+    explicit GameRecordReader(const std::string& path);
+
+    // Переходит к следующей записи; false в конце файла.
+    // Бросает std::runtime_error, если запись повреждена. Если испорчено только тело
+    // записи, offset() уже указывает на следующую и чтение можно продолжить.
+    bool next(GameRecordView& view);
+    std::size_t offset() const;
+
+private:
+    MappedFile file_;
+    std::size_t offset_;
+};
+
+// Дописывает записи в конец файла; append можно вызывать из нескольких потоков
+class GameRecordWriter {
+public:
+    // truncate — начать архив заново вместо дописывания в существующий.
+    // При дописывании в архив прежней версии его версия поднимается до текущей;
+    // в файл другого формата или более новой версии дописывать отказывается (std::runtime_error).
+    explicit GameRecordWriter(const std::string& path, bool truncate = false);
+    ~GameRecordWriter();
+
+    GameRecordWriter(const GameRecordWriter&) = delete;
+    GameRecordWriter& operator=(const GameRecordWriter&) = delete;
+
+    void append(const Layout& layout, std::uint64_t seed, int maxLives,
+                const GameResult& result, const std::vector<MoveRecord>& moves);
+    // Дописывает записи, заранее закодированные encode, одним куском
+    void appendEncoded(const std::vector<unsigned char>& records);
+    void flush();
+
+    // Кодирует запись в конец out (без заголовка файла)
+    static void encode(std::vector<unsigned char>& out, const Layout& layout, std::uint64_t seed, int maxLives,
+                       const GameResult& result, const std::vector<MoveRecord>& moves);
+    // Кодирует расстановку без партии (layoutOnly)
+    static void encodeLayout(std::vector<unsigned char>& out, const Layout& layout, std::uint64_t seed,
+                             int maxLives);
+
+private:
+    static void encodeRecord(std::vector<unsigned char>& out, const Layout& layout, std::uint64_t seed,
+                             int maxLives, int livesLeft, unsigned char flags, const std::vector<MoveRecord>& moves);
+
+    std::FILE* file_;
+    std::mutex mutex_;
+};
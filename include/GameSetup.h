@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class GameBoard;
+
+// Тип корабля во флоте: длина и количество
+struct ShipType {
+    int length;
+    int count;
+};
+
+// Положение одного корабля на поле
+struct ShipPlacement {
+    int x;
+    int y;
+    int length;
+    bool horizontal;
+};
+
+// Полная расстановка: размер поля, корабли и мины
+struct Layout {
+    int size = 0;
+    std::vector<ShipPlacement> ships;
+    std::vector<std::pair<int, int>> mines;
+};
+
+// Параметры игры по правилам (см. Rules.md)
+int calculateShipCount(int size);
+int calculateMineCount(int size);
+std::vector<ShipType> calculateFleet(int size);
+
+// Случайная расстановка флота и мин по правилам; детерминирована для заданного seed
+bool generateRandomLayout(int size, std::uint64_t seed, Layout& layout);
+
+// Переносит расстановку на поле; false, если какой-то корабль или мина не встаёт
+bool applyLayout(GameBoard& board, const Layout& layout);
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "GameSetup.h"
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+class GameBoard;
+class GameRecordWriter;
+class ThreadPool;
+
+// Пакетная загрузка расстановок из текстового файла.
+//
+// Одна расстановка на строку:
+//   <size>: <корабли> ; <мины>
+// корабль — x,y,L и h или v (например 0,0,4h), мина — x,y; элементы разделены пробелами.
+// Пустые строки и строки, начинающиеся с '#', пропускаются. Пример:
+//   10: 0,0,4h 0,2,3v 9,0,3v ... ; 5,5 7,1 2,9
+//
+// Расстановка проверяется по правилам GameBoard::canPlaceShip / canPlaceMine
+// (корабли ставятся в порядке записи, затем мины), флоту calculateFleet и числу мин
+// calculateMineCount.
+
+// Предел размера поля в файле, чтобы испорченная строка не заставила выделять гигантское поле
+const int kMaxLayoutSize = 100;
+
+struct LayoutLoadStats {
+    std::uint64_t lines = 0;     // строк с расстановками (без пустых и комментариев)
+    std::uint64_t valid = 0;
+    std::uint64_t invalid = 0;
+    std::uint64_t bytes = 0;
+};
+
+// Разбирает строку [begin, end) без перевода строки.
+// При синтаксической ошибке возвращает false, column — позиция с 1, message — описание.
+// В itemColumns (если задан) пишутся позиции всех кораблей, затем всех мин.
+bool parseLayoutLine(const char* begin, const char* end, Layout& layout, int& column, std::string& message,
+                     std::vector<int>* itemColumns = nullptr);
+
+// Дописывает расстановку строкой того же формата (с переводом строки)
+void appendLayoutLine(std::string& out, const Layout& layout);
+
+// Проверяет расстановку на рабочем поле board размера layout.size (поле сбрасывается;
+// при другом размере бросает std::invalid_argument).
+// При нарушении правил возвращает false, item — номер корабля (с 0) или
+// ships.size() + номер мины, -1 — расстановка целиком.
+bool validateLayout(const Layout& layout, GameBoard& board, int& item, std::string& message);
+
+class LayoutLoader {
+public:
+    // pool — пул для параллельной проверки; nullptr — всё в вызывающем потоке
+    explicit LayoutLoader(ThreadPool* pool = nullptr);
+
+    // Отображает файл path в память и проверяет все расстановки кусками параллельно.
+    // Правильные расстановки дописываются в archive записями layoutOnly (seed — номер строки),
+    // ошибки — в errors строками "<строка>:<столбец>: <описание>". Порядок вывода совпадает
+    // с порядком файла. archive и errors могут быть nullptr.
+    // Бросает std::runtime_error, если файл не открывается.
+    LayoutLoadStats load(const std::string& path, GameRecordWriter* archive, std::ostream* errors);
+
+private:
+    ThreadPool* pool_;
+};
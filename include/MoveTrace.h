@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class GameBoard;
+
+// Трассировка ходов в файл формата NumPy .npy.
+//
+// Файл — одномерный массив структур фиксированного размера, по кадру на каждый makeMove:
+//   game  <u4        — номер партии
+//   move  <u4        — номер хода в партии (с нуля)
+//   x, y  <i4        — выбранная клетка
+//   ship  <f8 (N, N) — вероятности кораблей перед ходом
+//   mine  <f8 (N, N) — вероятности мин перед ходом
+//   observed i1 (N, N) — поле глазами игрока перед ходом: коды GameBoard для
+//                        простреленных и помеченных клеток, 0 — нет информации
+// Читается без разбора: numpy.load(path, mmap_mode="r").
+class MoveTraceWriter {
+public:
+    MoveTraceWriter(const std::string& path, int boardSize);
+    ~MoveTraceWriter();
+
+    MoveTraceWriter(const MoveTraceWriter&) = delete;
+    MoveTraceWriter& operator=(const MoveTraceWriter&) = delete;
+
+    // Дописывает готовые кадры; потокобезопасно
+    void writeFrames(const unsigned char* data, std::size_t frames);
+    // Записывает итоговое число кадров в заголовок и закрывает файл
+    void close();
+
+    int getBoardSize() const;
+    std::size_t getFrameBytes() const;
+    std::uint64_t getFrameCount() const;
+
+private:
+    void writeHeader();
+
+    std::FILE* file_;
+    int boardSize_;
+    std::size_t frameBytes_;
+    std::size_t headerBytes_;
+    std::uint64_t frameCount_;
+    mutable std::mutex mutex_;
+};
+
+// Буфер кадров одного потока: копит кадры и сбрасывает их в writer пачками
+class MoveTraceBuffer {
+public:
+    explicit MoveTraceBuffer(MoveTraceWriter& writer, std::size_t batchBytes = 1 << 20);
+    ~MoveTraceBuffer();
+
+    MoveTraceBuffer(const MoveTraceBuffer&) = delete;
+    MoveTraceBuffer& operator=(const MoveTraceBuffer&) = delete;
+
+    void addFrame(std::uint32_t game, std::uint32_t move, const GameBoard& board, int x, int y);
+    void flush();
+
+private:
+    MoveTraceWriter& writer_;
+    std::vector<unsigned char> buffer_;
+    std::size_t frames_;
+    std::size_t batchFrames_;
+};
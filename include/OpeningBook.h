@@ -0,0 +1,68 @@
+#pragma once
+
+#include "BattleshipAlgorithm.h"
+#include "GameSetup.h"
+#include "MappedFile.h"
+#include "Simulation.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Дебютная книга: первый ход для каждой истории наблюдений первых ходов.
+// Книга строится офлайн (battleship_book) под размер поля, флот calculateFleet,
+// число мин calculateMineCount, версию движка и параметры алгоритма; движок
+// отображает файл в память только для чтения, так что одна копия делится между
+// потоками и процессами.
+//
+// Файл (все целые LE):
+//   "BSOB", uint32 версия формата, uint32 BattleshipAlgorithm::kEngineVersion,
+//   uint64 hashParams, uint32 size, uint32 mineCount, uint32 maxLives,
+//   uint32 depth, uint32 fleetCount, fleetCount пар uint32 (length, count),
+//   выравнивание нулями до 8 байт, uint64 capacity (степень двойки), uint64 число записей,
+//   capacity ячеек по 16 байт: uint64 ключ (0 — пусто), uint32 клетка, uint32 голоса.
+// Ячейки — открытая адресация с линейным пробированием от (ключ & (capacity - 1)).
+
+struct OpeningBookEntry {
+    std::uint64_t key;
+    int cell;        // y * size + x
+    int votes;       // сколько партий выбрали этот ход
+};
+
+class OpeningBook {
+public:
+    // Ключ пустой истории
+    static const std::uint64_t kRootKey = 0x6a09e667f3bcc909ULL;
+
+    // Ключ после выстрела в cell с исходом outcome; никогда не равен 0
+    static std::uint64_t extendKey(std::uint64_t key, int cell, ShotOutcome outcome);
+
+    // Записывает книгу для партий с maxLives жизнями и параметрами params;
+    // бросает std::runtime_error при ошибке
+    static void write(const std::string& path, int size, int maxLives, const AlgorithmParams& params,
+                      int depth, const std::vector<OpeningBookEntry>& entries);
+
+    // Открывает книгу; бросает std::runtime_error, если файл повреждён, построен
+    // не под правила calculateFleet / calculateMineCount или другой версией движка
+    explicit OpeningBook(const std::string& path);
+
+    int size() const;
+    int maxLives() const;
+    std::uint64_t paramsHash() const;
+    // Книга покрывает ходы с номерами [0, depth)
+    int depth() const;
+    std::size_t entryCount() const;
+
+    // Клетка для истории key или -1
+    int lookup(std::uint64_t key) const;
+
+private:
+    MappedFile file_;
+    int size_;
+    int maxLives_;
+    std::uint64_t paramsHash_;
+    int depth_;
+    std::size_t entryCount_;
+    const unsigned char* slots_;
+    std::uint64_t mask_;
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "BattleshipAlgorithm.h"
+#include "GameSetup.h"
+#include "Simulation.h"
+#include "Statistics.h"
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <vector>
+
+constexpr int kSearchStageCount = static_cast<int>(SearchStage::Book) + 1;
+
+// Гистограмма целых значений [0, bins) поверх чужих счётчиков (блока накопителя);
+// большие значения попадают в последнюю корзину.
+// Пишет только поток-владелец (без блокировок и атомарных RMW), читать можно из
+// любого потока в любой момент.
+class ShardHistogram {
+public:
+    ShardHistogram(std::atomic<std::uint64_t>* bins, int count);
+
+    void add(int value);
+    // Прибавляет корзины к counts, расширяя его при необходимости
+    void addTo(std::vector<std::uint64_t>& counts) const;
+
+private:
+    std::atomic<std::uint64_t>* bins_;
+    int count_;
+};
+
+// Сводка по одному размеру поля; size == 0 — по всем размерам вместе.
+// Гистограммы: [k] — сколько раз значение было равно k.
+struct SizeSummary {
+    int size = 0;
+    std::uint64_t games = 0;
+    std::uint64_t wins = 0;
+    std::vector<std::uint64_t> movesToWin;  // только выигранные партии
+    std::vector<std::uint64_t> livesLost;
+    std::vector<std::uint64_t> killLength;  // ходов от первого попадания до опустевшего списка раненых
+    std::uint64_t stageShots[kSearchStageCount] = {};
+    std::uint64_t stageHits[kSearchStageCount] = {};
+};
+
+// 95% интервал для среднего по гистограмме
+Interval histogramMean(const std::vector<std::uint64_t>& counts);
+// Наименьшее k, до которого (включительно) набирается доля q значений; -1 для пустой
+int histogramQuantile(const std::vector<std::uint64_t>& counts, double q);
+
+// Потоковая сводка результатов партий.
+// У каждого потока-писателя свой накопитель: record только увеличивает его счётчики
+// (relaxed-запись, без блокировок), snapshot суммирует накопители на лету.
+// Все счётчики накопителя лежат одним блоком целых строк кэша, поэтому потоки не
+// делят строки.
+// Снимок во время записи может отставать на несколько партий и не быть согласован
+// между счётчиками; снимок после завершения писателей точен.
+class ResultAggregator {
+public:
+    // sizes — размеры полей, которые будут встречаться; threads — число писателей
+    ResultAggregator(const std::vector<int>& sizes, int threads);
+    ~ResultAggregator();
+
+    ResultAggregator(const ResultAggregator&) = delete;
+    ResultAggregator& operator=(const ResultAggregator&) = delete;
+
+    // Учитывает партию в накопителе потока thread; вызывать только из этого потока.
+    // moves — ходы партии (с этапами), как их возвращает playGame.
+    // Бросает std::invalid_argument для размера, не переданного в конструктор.
+    void record(int thread, const Layout& layout, const GameResult& result,
+                const std::vector<MoveRecord>& moves);
+
+    // Сводка по каждому размеру в порядке конструктора и последней строкой — общая
+    std::vector<SizeSummary> snapshot() const;
+
+private:
+    struct SizeShard;
+    struct Shard;
+
+    std::vector<int> sizes_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+// Таблица: строка на размер, столбцы — счётчики, средние с 95% интервалами и квантили
+void writeSummaryCsv(std::ostream& out, const std::vector<SizeSummary>& summary);
+// То же в JSON, вместе с полными гистограммами
+void writeSummaryJson(std::ostream& out, const std::vector<SizeSummary>& summary);
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "BattleshipAlgorithm.h"
+#include "GameSetup.h"
+#include <cstdint>
+#include <vector>
+
+class GameBoard;
+
+// Результат одного выстрела
+enum class ShotOutcome : std::uint8_t {
+    Miss = 0,
+    Hit = 1,
+    Mine = 2,
+    Sunk = 3
+};
+
+struct MoveRecord {
+    int x;
+    int y;
+    ShotOutcome outcome;
+    SearchStage stage = SearchStage::None;  // этап, выбравший ход; в архив не пишется
+};
+
+struct GameResult {
+    int moves = 0;
+    int livesLeft = 0;
+    bool victory = false;
+};
+
+// Классифицирует выстрел, уже сделанный через GameBoard::makeShot
+ShotOutcome classifyShot(const GameBoard& board, int x, int y, bool hit);
+
+// Играет партию алгоритмом до победы или потери всех жизней.
+// Если moves != nullptr, в него записывается последовательность ходов.
+// Для размеров 10, 12, 15 и 20 используется FixedBattleshipAlgorithm<N>,
+// для остальных — динамический BattleshipAlgorithm; партии у них совпадают.
+GameResult playGame(const Layout& layout, std::vector<MoveRecord>* moves = nullptr,
+                    const AlgorithmParams& params = AlgorithmParams());
+
+// Та же партия, но всегда на динамическом поле (эталон для сверки)
+GameResult playDynamicGame(const Layout& layout, std::vector<MoveRecord>* moves = nullptr,
+                           const AlgorithmParams& params = AlgorithmParams());
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+
+// Доверительный интервал [low, high] вокруг оценки value
+struct Interval {
+    double value;
+    double low;
+    double high;
+};
+
+// Среднее и дисперсия в один проход (алгоритм Уэлфорда)
+class RunningStats {
+public:
+    void add(double value);
+    // times одинаковых значений разом (для гистограмм)
+    void add(double value, std::uint64_t times);
+    void merge(const RunningStats& other);
+
+    std::uint64_t count() const;
+    double mean() const;
+    double variance() const;
+    // 95% интервал для среднего (нормальное приближение)
+    Interval meanInterval() const;
+
+private:
+    std::uint64_t count_ = 0;
+    double mean_ = 0.0;
+    double m2_ = 0.0;
+};
+
+// 95% интервал Уилсона для доли successes / trials
+Interval wilsonInterval(std::uint64_t successes, std::uint64_t trials);
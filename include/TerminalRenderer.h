@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+class GameBoard;
+
+// Отрисовка поля в терминале через ANSI-последовательности.
+// Кадр собирается в строки целиком, а в терминал одной записью уходят только
+// изменившиеся участки с переводом курсора. Частота кадров ограничена: в обычном
+// режиме draw ждёт до следующего кадра, в ускоренном лишние кадры пропускаются.
+// Поле, которое не помещается в терминал, показывается через окно с прокруткой.
+class TerminalRenderer {
+public:
+    explicit TerminalRenderer(std::ostream& out, double framesPerSecond = 30.0);
+
+    void setFramesPerSecond(double framesPerSecond);
+    void setFastForward(bool enabled);
+    bool isFastForward() const;
+
+    // Сдвигает окно просмотра на dx столбцов и dy строк
+    void scroll(int dx, int dy);
+    // Сдвигает окно так, чтобы клетка (x, y) была видна
+    void follow(int x, int y);
+    // Поле целиком помещается в окно
+    bool isViewportFull() const;
+
+    // Стирает экран; следующий кадр рисуется целиком
+    void clear();
+
+    // Рисует поле и строки статуса под ним, курсор остаётся под кадром.
+    // force — рисовать без ожидания и пропуска. Возвращает false, если кадр пропущен.
+    bool draw(const GameBoard& board, bool showShips, const std::vector<std::string>& status,
+              bool force = false);
+
+private:
+    void updateViewport(int boardSize, int statusLines);
+    void compose(const GameBoard& board, bool showShips, const std::vector<std::string>& status);
+    void emitDiff();
+
+    std::ostream& out_;
+    std::chrono::steady_clock::duration frameInterval_;
+    std::chrono::steady_clock::time_point nextFrame_;
+    bool fastForward_;
+
+    // Окно просмотра: левая верхняя клетка и число видимых столбцов и строк
+    int viewX_;
+    int viewY_;
+    int viewColumns_;
+    int viewRows_;
+    int boardSize_;
+    int terminalColumns_;
+
+    std::vector<std::string> frame_;
+    std::vector<std::string> shown_;  // то, что сейчас на экране
+    std::string buffer_;
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Общий пул потоков для распараллеливания внутри одного хода.
+// Пул можно делить между несколькими алгоритмами: поток, вызвавший parallelFor,
+// сам выполняет задачи из очереди, пока ждёт свои.
+class ThreadPool {
+public:
+    // threads — число рабочих потоков; 0 — по числу ядер минус вызывающий поток
+    explicit ThreadPool(int threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const;
+
+    // Вызывает fn(i) для каждого i из [0, count) и ждёт завершения всех вызовов.
+    // Первое исключение из fn пробрасывается вызывающему.
+    void parallelFor(int count, const std::function<void(int)>& fn);
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable taskReady_;
+    std::condition_variable taskDone_;
+    bool stopping_;
+};
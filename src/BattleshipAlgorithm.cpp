@@ -1,14 +1,73 @@
 #include "../include/BattleshipAlgorithm.h"
+#include "../include/EndgameSolver.h"
 #include "../include/GameBoard.h"
+#include "../include/MoveTrace.h"
+#include "../include/OpeningBook.h"
+#include "../include/Simulation.h"
+#include "../include/ThreadPool.h"
+#include <chrono>
 #include <limits>
 #include <cmath>
+#include <cstring>
 #include <random>
 #include <algorithm>
 #include <queue>
 #include <set>
+#include <stdexcept>
 
-BattleshipAlgorithm::BattleshipAlgorithm(std::shared_ptr<GameBoard> board, int maxLives)
-    : board_(board), maxLives_(maxLives), currentLives_(maxLives), hasLastHit(false) {
+std::vector<std::pair<int, int>> squarePatternCells(int n, int size);
+
+BattleshipAlgorithm::BattleshipAlgorithm(std::shared_ptr<GameBoard> board, int maxLives,
+                                         const AlgorithmParams& params)
+    : board_(board), params_(params), maxLives_(maxLives), currentLives_(maxLives), hasLastHit(false),
+      noShip_(board->getSize() * board->getSize(), 0), noMine_(board->getSize() * board->getSize(), 0),
+      lastMove_(-1, -1), trace_(nullptr), traceGame_(0), moveIndex_(0),
+      fallbackCursor_(0), pool_(nullptr), parallelMinSize_(kDefaultParallelMinSize), endgame_(nullptr),
+      book_(nullptr), historyKey_(OpeningBook::kRootKey) {
+    // Штраф копится сложением, как при поклеточном обходе, чтобы суммы совпадали бит в бит
+    neighborPenalties_[0] = 0.0;
+    for (int k = 1; k < 10; ++k) {
+        neighborPenalties_[k] = neighborPenalties_[k - 1] + params_.neighborPenalty;
+    }
+    pattern3_ = squarePatternCells(3, board->getSize());
+    pattern4_ = squarePatternCells(4, board->getSize());
+    initializeProbabilities();
+}
+
+std::uint64_t hashParams(const AlgorithmParams& params) {
+    // FNV-1a по битам полей в фиксированном порядке, без учёта выравнивания структуры
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    auto mix = [&hash](std::uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            hash ^= (value >> (8 * i)) & 0xff;
+            hash *= 0x100000001b3ULL;
+        }
+    };
+    for (double value : {params.lambdaMax, params.riskExponent, params.neighborPenalty, params.shipFactor,
+                         params.mineFactor, params.mineThreshold}) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        mix(bits);
+    }
+    mix(static_cast<std::uint64_t>(static_cast<std::int64_t>(params.lowLives)));
+    return hash;
+}
+
+void BattleshipAlgorithm::reset(int maxLives) {
+    if (book_ && book_->maxLives() != maxLives) {
+        throw std::invalid_argument("Opening book is built for another number of lives");
+    }
+    maxLives_ = maxLives;
+    currentLives_ = maxLives;
+    hasLastHit = false;
+    woundedCells_.clear();
+    std::fill(noShip_.begin(), noShip_.end(), 0);
+    std::fill(noMine_.begin(), noMine_.end(), 0);
+    lastMove_ = {-1, -1};
+    moveIndex_ = 0;
+    report_ = MoveReport();
+    fallbackCursor_ = 0;
+    historyKey_ = OpeningBook::kRootKey;
     initializeProbabilities();
 }
 
@@ -25,11 +84,10 @@ void BattleshipAlgorithm::initializeProbabilities() {
 }
 
 double BattleshipAlgorithm::calculateRiskCoefficient() const {
-    const double lambdaMax = 2.0;
     double lifeRatio = static_cast<double>(currentLives_) / maxLives_;
     
     // Экспоненциальная функция для более агрессивного изменения lambda
-    return lambdaMax * std::exp(-3.0 * lifeRatio);
+    return params_.lambdaMax * std::exp(params_.riskExponent * lifeRatio);
 }
 
 double BattleshipAlgorithm::calculateUtility(int x, int y) const {
@@ -40,19 +98,8 @@ double BattleshipAlgorithm::calculateUtility(int x, int y) const {
     double mineProb = mineProbs[y][x];
     double lambda = calculateRiskCoefficient();
     
-    // Добавляем штраф за клетки рядом с уже проверенными
-    double neighborPenalty = 0.0;
-    for (int dx = -1; dx <= 1; ++dx) {
-        for (int dy = -1; dy <= 1; ++dy) {
-            int nx = x + dx;
-            int ny = y + dy;
-            if (nx >= 0 && nx < board_->getSize() && ny >= 0 && ny < board_->getSize()) {
-                if (board_->getBoard()[ny][nx] != 0) {
-                    neighborPenalty += 0.1;
-                }
-            }
-        }
-    }
+    // Добавляем штраф за клетки рядом с уже проверенными (счётчик ведёт GameBoard)
+    double neighborPenalty = neighborPenalties_[board_->getNeighborCount(x, y)];
     
     return shipProb - lambda * mineProb - neighborPenalty;
 }
@@ -76,14 +123,14 @@ std::pair<int, int> BattleshipAlgorithm::findKillMove() {
             int minY = *std::min_element(ys.begin(), ys.end());
             int maxY = *std::max_element(ys.begin(), ys.end());
             int x = woundedCells_[0].first;
-            if (minY - 1 >= 0 && board_->getShotsBoard()[minY - 1][x] == 0) {
+            if (minY - 1 >= 0 && isHuntable(x, minY - 1)) {
                 double utility = calculateUtility(x, minY - 1);
                 if (utility > bestUtility) {
                     bestUtility = utility;
                     bestMove = {x, minY - 1};
                 }
             }
-            if (maxY + 1 < size && board_->getShotsBoard()[maxY + 1][x] == 0) {
+            if (maxY + 1 < size && isHuntable(x, maxY + 1)) {
                 double utility = calculateUtility(x, maxY + 1);
                 if (utility > bestUtility) {
                     bestUtility = utility;
@@ -97,14 +144,14 @@ std::pair<int, int> BattleshipAlgorithm::findKillMove() {
             int minX = *std::min_element(xs.begin(), xs.end());
             int maxX = *std::max_element(xs.begin(), xs.end());
             int y = woundedCells_[0].second;
-            if (minX - 1 >= 0 && board_->getShotsBoard()[y][minX - 1] == 0) {
+            if (minX - 1 >= 0 && isHuntable(minX - 1, y)) {
                 double utility = calculateUtility(minX - 1, y);
                 if (utility > bestUtility) {
                     bestUtility = utility;
                     bestMove = {minX - 1, y};
                 }
             }
-            if (maxX + 1 < size && board_->getShotsBoard()[y][maxX + 1] == 0) {
+            if (maxX + 1 < size && isHuntable(maxX + 1, y)) {
                 double utility = calculateUtility(maxX + 1, y);
                 if (utility > bestUtility) {
                     bestUtility = utility;
@@ -123,7 +170,7 @@ std::pair<int, int> BattleshipAlgorithm::findKillMove() {
                     int nx = x + dir.first;
                     int ny = y + dir.second;
                     if (nx >= 0 && nx < size && ny >= 0 && ny < size) {
-                        if (board_->getShotsBoard()[ny][nx] == 0) {
+                        if (isHuntable(nx, ny)) {
                             double utility = calculateUtility(nx, ny);
                             if (utility > bestUtility) {
                                 bestUtility = utility;
@@ -146,7 +193,7 @@ std::pair<int, int> BattleshipAlgorithm::findKillMove() {
                 int nx = x + dir.first;
                 int ny = y + dir.second;
                 if (nx >= 0 && nx < size && ny >= 0 && ny < size) {
-                    if (board_->getShotsBoard()[ny][nx] == 0) {
+                    if (isHuntable(nx, ny)) {
                         double utility = calculateUtility(nx, ny);
                         if (utility > bestUtility) {
                             bestUtility = utility;
@@ -180,6 +227,19 @@ std::vector<std::pair<int, int>> getSquarePattern(int n, int x0, int y0, int siz
     return pattern;
 }
 
+// Объединение шаблонов всех квадратов поля, по x, затем по y. Зависит только от n и
+// размера поля, поэтому строится один раз в конструкторе, а не на каждом ходу
+std::vector<std::pair<int, int>> squarePatternCells(int n, int size) {
+    std::set<std::pair<int, int>> patternCells;
+    for (int y0 = 0; y0 < size; y0 += n) {
+        for (int x0 = 0; x0 < size; x0 += n) {
+            auto pattern = getSquarePattern(n, x0, y0, size);
+            for (auto cell : pattern) patternCells.insert(cell);
+        }
+    }
+    return std::vector<std::pair<int, int>>(patternCells.begin(), patternCells.end());
+}
+
 int getMaxAliveShipLength(const GameBoard& board) {
     int maxLen = 0;
     for (const auto& ship : board.getShips()) {
@@ -191,16 +251,44 @@ int getMaxAliveShipLength(const GameBoard& board) {
     return maxLen;
 }
 
-// Возвращает список центров всех возможных позиций для самого длинного корабля
-std::vector<std::pair<int, int>> findMaxShipCandidates(const GameBoard& board, int maxShipLen) {
+// Бюджет времени на выбор хода. Часы опрашиваются не на каждой клетке, а раз в kCheckInterval
+struct BattleshipAlgorithm::SearchBudget {
+    static const int kCheckInterval = 64;
+
+    bool limited = false;
+    std::chrono::steady_clock::time_point deadline;
+    bool isExpired = false;
+
+    // Точная проверка — на границах этапов; внутри циклов часы опрашивает argmaxBands
+    bool expiredNow() {
+        if (limited && !isExpired) isExpired = std::chrono::steady_clock::now() >= deadline;
+        return isExpired;
+    }
+};
+
+// Возвращает список центров всех возможных позиций для самого длинного корабля.
+// Окно не может содержать простреленных клеток и клеток noShip. Часы опрашиваются
+// раз в kCheckInterval клеток; по истечении бюджета список обрывается, а
+// budget.isExpired выставлен
+template <class Budget>
+std::vector<std::pair<int, int>> findMaxShipCandidates(const GameBoard& board, const std::vector<unsigned char>& noShip,
+                                                       int maxShipLen, Budget& budget) {
     std::vector<std::pair<int, int>> candidates;
     int size = board.getSize();
     const auto& shots = board.getShotsBoard();
+    int work = 0;
+    int nextCheck = Budget::kCheckInterval;
+    auto expired = [&]() {
+        work += size;
+        if (!budget.limited || work < nextCheck) return false;
+        nextCheck = work + Budget::kCheckInterval;
+        return budget.expiredNow();
+    };
     // По горизонтали
     for (int y = 0; y < size; ++y) {
         int streak = 0;
         for (int x = 0; x < size; ++x) {
-            if (shots[y][x] == 0) streak++;
+            if (shots[y][x] == 0 && !noShip[y * size + x]) streak++;
             else streak = 0;
             if (streak >= maxShipLen) {
                 int center = x - maxShipLen / 2;
@@ -208,12 +296,13 @@ std::vector<std::pair<int, int>> findMaxShipCandidates(const GameBoard& board, i
                     candidates.emplace_back(center, y);
             }
         }
+        if (expired()) return candidates;
     }
     // По вертикали
     for (int x = 0; x < size; ++x) {
         int streak = 0;
         for (int y = 0; y < size; ++y) {
-            if (shots[y][x] == 0) streak++;
+            if (shots[y][x] == 0 && !noShip[y * size + x]) streak++;
             else streak = 0;
             if (streak >= maxShipLen) {
                 int center = y - maxShipLen / 2;
@@ -221,23 +310,156 @@ std::vector<std::pair<int, int>> findMaxShipCandidates(const GameBoard& board, i
                     candidates.emplace_back(x, center);
             }
         }
+        if (expired()) return candidates;
     }
     return candidates;
 }
 
-std::pair<int, int> BattleshipAlgorithm::findBestMove() {
+namespace {
+
+// Лучший элемент полосы индексов
+struct BandBest {
+    double value;
+    std::pair<int, int> cell = {-1, -1};
+    int evaluated = 0;
+    bool interrupted = false;
+};
+
+// Максимум по индексам [0, count): evaluate(i, best) обновляет best строгим сравнением,
+// поэтому при равенстве остаётся более ранний индекс. С пулом индексы режутся на
+// непрерывные полосы, а полосы сводятся по порядку — результат совпадает с
+// последовательным обходом бит в бит. Бюджет каждая полоса проверяет сама.
+template <class Budget, class Evaluate>
+BandBest argmaxBands(ThreadPool* pool, int count, double initial, const Budget& budget, Evaluate evaluate) {
+    int bands = pool ? std::max(1, std::min(count, pool->size() + 1)) : 1;
+    std::vector<BandBest> results(bands, BandBest{initial});
+    auto runBand = [&](int band) {
+        BandBest& best = results[band];
+        int begin = static_cast<int>(static_cast<long long>(count) * band / bands);
+        int end = static_cast<int>(static_cast<long long>(count) * (band + 1) / bands);
+        // Работа — пройденные индексы плюс оценённые клетки: индекс может быть целой
+        // строкой поля, и тогда счёт по индексам почти не опрашивал бы часы
+        int nextCheck = Budget::kCheckInterval;
+        for (int i = begin; i < end; ++i) {
+            if (budget.limited && (i - begin) + best.evaluated >= nextCheck) {
+                if (std::chrono::steady_clock::now() >= budget.deadline) {
+                    best.interrupted = true;
+                    break;
+                }
+                nextCheck = (i - begin) + best.evaluated + Budget::kCheckInterval;
+            }
+            evaluate(i, best);
+        }
+    };
+    if (bands == 1) {
+        runBand(0);
+    } else {
+        pool->parallelFor(bands, runBand);
+    }
+    BandBest total{initial};
+    for (const auto& band : results) {
+        if (band.cell.first != -1 && band.value > total.value) {
+            total.value = band.value;
+            total.cell = band.cell;
+        }
+        total.evaluated += band.evaluated;
+        total.interrupted = total.interrupted || band.interrupted;
+    }
+    return total;
+}
+
+} // namespace
+
+ThreadPool* BattleshipAlgorithm::parallelPool() const {
+    // Маленькие поля быстрее перебрать в одном потоке
+    return (pool_ && board_->getSize() >= parallelMinSize_) ? pool_ : nullptr;
+}
+
+void BattleshipAlgorithm::setThreadPool(ThreadPool* pool, int minBoardSize) {
+    pool_ = pool;
+    parallelMinSize_ = minBoardSize;
+}
+
+void BattleshipAlgorithm::setEndgameSolver(EndgameSolver* solver) {
+    endgame_ = solver;
+}
+
+void BattleshipAlgorithm::setOpeningBook(const OpeningBook* book) {
+    if (book && book->size() != board_->getSize()) {
+        throw std::invalid_argument("Opening book is built for another board size");
+    }
+    if (book && book->maxLives() != maxLives_) {
+        throw std::invalid_argument("Opening book is built for another number of lives");
+    }
+    if (book && book->paramsHash() != hashParams(params_)) {
+        throw std::invalid_argument("Opening book is built for other algorithm parameters");
+    }
+    book_ = book;
+}
+
+std::pair<int, int> BattleshipAlgorithm::findFallbackMove() {
+    // Клетки только простреливаются, поэтому курсор двигается лишь вперёд
+    int size = board_->getSize();
+    const auto& shots = board_->getShotsBoard();
+    while (fallbackCursor_ < size * size && shots[fallbackCursor_ / size][fallbackCursor_ % size] != 0) {
+        fallbackCursor_++;
+    }
+    if (fallbackCursor_ == size * size) return {-1, -1};
+    return {fallbackCursor_ % size, fallbackCursor_ / size};
+}
+
+std::pair<int, int> BattleshipAlgorithm::findBestMove(SearchBudget& budget) {
     double bestUtility = -std::numeric_limits<double>::infinity();
     std::pair<int, int> bestMove = {-1, -1};
+    // Запасной ход на случай, если бюджет кончится раньше, чем отработает хотя бы один этап
+    std::pair<int, int> fallback = findFallbackMove();
+    report_.stage = SearchStage::Fallback;
+    if (fallback.first == -1) {
+        report_.complete = true;
+        return fallback;
+    }
+    // Первые ходы — из книги по истории наблюдений
+    if (book_ && static_cast<int>(moveIndex_) < book_->depth()) {
+        int cell = book_->lookup(historyKey_);
+        int size = board_->getSize();
+        if (cell != -1 && board_->getShotsBoard()[cell / size][cell % size] == 0) {
+            report_.stage = SearchStage::Book;
+            report_.complete = true;
+            return {cell % size, cell / size};
+        }
+    }
+    // Если расстановок осталось немного, ход выбирается точным перебором
+    if (endgame_) {
+        if (budget.expiredNow()) return fallback;
+        // Перебору — половина оставшегося срока, чтобы при обрыве успели отработать эвристики
+        auto deadline = std::chrono::steady_clock::time_point::max();
+        if (budget.limited) {
+            auto now = std::chrono::steady_clock::now();
+            deadline = now + (budget.deadline - now) / 2;
+        }
+        auto move = endgame_->findMove(*board_, currentLives_, deadline);
+        if (move.first != -1) {
+            report_.stage = SearchStage::Endgame;
+            report_.complete = true;
+            return move;
+        }
+    }
     // Если есть раненые клетки, используем режим добивания
     if (!woundedCells_.empty()) {
+        if (budget.expiredNow()) return fallback;
         auto move = findKillMove();
-        if (move.first != -1) return move;
+        report_.stage = SearchStage::Kill;
+        if (move.first != -1) {
+            report_.complete = true;
+            return move;
+        }
     }
     int size = board_->getSize();
     int n = getMaxAliveShipLength(*board_);
     const auto& mineProbs = board_->getMineProbabilities();
     // Если было попадание, сначала проверяем соседние клетки
     if (hasLastHit) {
+        if (budget.expiredNow()) return fallback;
         std::vector<std::pair<int, int>> directions = {
             {-1, 0}, {1, 0}, {0, -1}, {0, 1}
         };
@@ -245,8 +467,9 @@ std::pair<int, int> BattleshipAlgorithm::findBestMove() {
             int nx = lastHitX + dir.first;
             int ny = lastHitY + dir.second;
             if (nx >= 0 && nx < board_->getSize() && ny >= 0 && ny < board_->getSize()) {
-                if (board_->getShotsBoard()[ny][nx] == 0) {
+                if (isHuntable(nx, ny)) {
                     double utility = calculateUtility(nx, ny);
+                    report_.evaluatedCells++;
                     if (utility > bestUtility) {
                         bestUtility = utility;
                         bestMove = {nx, ny};
@@ -254,83 +477,141 @@ std::pair<int, int> BattleshipAlgorithm::findBestMove() {
                 }
             }
         }
+        report_.stage = SearchStage::LastHit;
     }
     // Новый шаг: ищем все возможные позиции для самого длинного корабля, приоритет — безопасность
     if (bestMove.first == -1) {
-        auto candidates = findMaxShipCandidates(*board_, n);
-        double minMineSum = 1e9;
-        std::pair<int, int> safestCell = {-1, -1};
-        for (auto [x, y] : candidates) {
-            double mineSumH = 0.0, mineSumV = 0.0;
-            bool validH = true, validV = true;
-            // горизонталь
-            for (int d = 0; d < n; ++d) {
-                if (x + d >= size || board_->getShotsBoard()[y][x + d] != 0) { validH = false; break; }
-                mineSumH += mineProbs[y][x + d];
-            }
-            // вертикаль
-            for (int d = 0; d < n; ++d) {
-                if (y + d >= size || board_->getShotsBoard()[y + d][x] != 0) { validV = false; break; }
-                mineSumV += mineProbs[y + d][x];
-            }
-            if (validH && mineSumH < minMineSum) {
-                minMineSum = mineSumH;
-                safestCell = {x + n/2, y};
-            }
-            if (validV && mineSumV < minMineSum) {
-                minMineSum = mineSumV;
-                safestCell = {x, y + n/2};
-            }
-        }
+        if (budget.expiredNow()) return fallback;
+        auto candidates = findMaxShipCandidates(*board_, noShip_, n, budget);
+        // Список не достроен — до поиска безопасного окна дело не дошло
+        if (budget.isExpired) return fallback;
+        // Ищем окно с минимальной суммой вероятностей мин как максимум её отрицания
+        BandBest safest = argmaxBands(parallelPool(), static_cast<int>(candidates.size()), -1e9, budget,
+            [&](int i, BandBest& best) {
+                auto [x, y] = candidates[i];
+                best.evaluated++;
+                double mineSumH = 0.0, mineSumV = 0.0;
+                bool validH = true, validV = true;
+                // горизонталь
+                for (int d = 0; d < n; ++d) {
+                    if (x + d >= size || !isHuntable(x + d, y)) { validH = false; break; }
+                    mineSumH += mineProbs[y][x + d];
+                }
+                // вертикаль
+                for (int d = 0; d < n; ++d) {
+                    if (y + d >= size || !isHuntable(x, y + d)) { validV = false; break; }
+                    mineSumV += mineProbs[y + d][x];
+                }
+                if (validH && -mineSumH > best.value) {
+                    best.value = -mineSumH;
+                    best.cell = {x + n/2, y};
+                }
+                if (validV && -mineSumV > best.value) {
+                    best.value = -mineSumV;
+                    best.cell = {x, y + n/2};
+                }
+            });
+        report_.evaluatedCells += safest.evaluated;
+        double minMineSum = -safest.value;
+        std::pair<int, int> safestCell = safest.cell;
+        bool interrupted = safest.interrupted;
         // Если мало жизней, избегаем дыр с высокой вероятностью мин
-        double mineThreshold = 0.5 * n; // можно скорректировать
-        if (currentLives_ <= 2 && minMineSum > mineThreshold) {
-            // fallback — ищем менее опасные клетки по шаблону
-        } else if (safestCell.first != -1) {
+        double mineThreshold = params_.mineThreshold * n;
+        bool acceptable = safestCell.first != -1 &&
+                          !(currentLives_ <= params_.lowLives && minMineSum > mineThreshold);
+        if (interrupted) {
+            // Бюджет кончился посреди перебора — берём лучшее из просмотренного
+            return acceptable ? safestCell : fallback;
+        }
+        report_.stage = SearchStage::Candidates;
+        if (acceptable) {
             bestMove = safestCell;
         }
     }
     // Если не нашли — шаблон квадратов
     if (bestMove.first == -1) {
-        std::set<std::pair<int, int>> patternCells;
-        for (int y0 = 0; y0 < size; y0 += n) {
-            for (int x0 = 0; x0 < size; x0 += n) {
-                auto pattern = getSquarePattern(n, x0, y0, size);
-                for (auto cell : pattern) patternCells.insert(cell);
-            }
-        }
-        for (auto [x, y] : patternCells) {
-            if (board_->getShotsBoard()[y][x] == 0) {
-                double utility = calculateUtility(x, y);
-                if (utility > bestUtility) {
-                    bestUtility = utility;
-                    bestMove = {x, y};
+        if (budget.expiredNow()) return fallback;
+        static const std::vector<std::pair<int, int>> kNoPattern;
+        const auto& cells = n == 3 ? pattern3_ : n == 4 ? pattern4_ : kNoPattern;
+        BandBest best = argmaxBands(parallelPool(), static_cast<int>(cells.size()), bestUtility, budget,
+            [&](int i, BandBest& band) {
+                auto [x, y] = cells[i];
+                if (isHuntable(x, y)) {
+                    double utility = calculateUtility(x, y);
+                    band.evaluated++;
+                    if (utility > band.value) {
+                        band.value = utility;
+                        band.cell = {x, y};
+                    }
                 }
-            }
+            });
+        report_.evaluatedCells += best.evaluated;
+        if (best.cell.first != -1) {
+            bestUtility = best.value;
+            bestMove = best.cell;
         }
+        if (best.interrupted) return bestMove.first != -1 ? bestMove : fallback;
+        report_.stage = SearchStage::Pattern;
     }
     // Если все клетки паттерна уже прострелены, fallback — по всему полю
     if (bestMove.first == -1) {
-        for (int i = 0; i < board_->getSize(); ++i) {
-            for (int j = 0; j < board_->getSize(); ++j) {
-                if (board_->getShotsBoard()[i][j] == 0) {
-                    double utility = calculateUtility(j, i);
-                    if (utility > bestUtility) {
-                        bestUtility = utility;
-                        bestMove = {j, i};
+        if (budget.expiredNow()) return fallback;
+        // Полосы по строкам: внутри строки обход слева направо, как в последовательном цикле
+        BandBest best = argmaxBands(parallelPool(), size, bestUtility, budget,
+            [&](int i, BandBest& band) {
+                for (int j = 0; j < size; ++j) {
+                    if (isHuntable(j, i)) {
+                        double utility = calculateUtility(j, i);
+                        band.evaluated++;
+                        if (utility > band.value) {
+                            band.value = utility;
+                            band.cell = {j, i};
+                        }
                     }
                 }
-            }
+            });
+        report_.evaluatedCells += best.evaluated;
+        if (best.cell.first != -1) {
+            bestUtility = best.value;
+            bestMove = best.cell;
         }
+        if (best.interrupted) return bestMove.first != -1 ? bestMove : fallback;
+        report_.stage = SearchStage::FullBoard;
     }
+    report_.complete = true;
     return bestMove;
 }
 
 bool BattleshipAlgorithm::makeMove() {
+    SearchBudget budget;
+    return playMove(budget);
+}
+
+bool BattleshipAlgorithm::makeMove(std::chrono::steady_clock::time_point deadline) {
+    SearchBudget budget;
+    budget.limited = true;
+    budget.deadline = deadline;
+    return playMove(budget);
+}
+
+bool BattleshipAlgorithm::playMove(SearchBudget& budget) {
+    auto start = std::chrono::steady_clock::now();
+    report_ = MoveReport();
+    lastMove_ = {-1, -1};
     if (currentLives_ <= 0) return false;
     
-    auto [x, y] = findBestMove();
-    if (x == -1 || y == -1) return false;  // Нет доступных ходов
+    auto [x, y] = findBestMove(budget);
+    auto micros = [&start]() {
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    };
+    report_.searchMicros = micros();
+    if (x == -1 || y == -1) {  // Нет доступных ходов
+        report_.elapsedMicros = report_.searchMicros;
+        return false;
+    }
+    lastMove_ = {x, y};
+    if (trace_) trace_->addFrame(traceGame_, moveIndex_, *board_, x, y);
+    moveIndex_++;
     
     bool hit = board_->makeShot(x, y);
     
@@ -351,6 +632,7 @@ bool BattleshipAlgorithm::makeMove() {
         }
         updateProbabilities(x, y, true, false);
         // Проверяем, не потоплен ли корабль (все клетки вокруг раненых)
+        std::vector<std::pair<int, int>> sunkCells;
         for (const auto& ship : board_->getShips()) {
             bool allHit = true;
             for (const auto& cell : ship.cells) {
@@ -360,18 +642,27 @@ bool BattleshipAlgorithm::makeMove() {
                 }
             }
             if (allHit) {
-                // Удаляем все клетки этого корабля из woundedCells_
+                // Удаляем все клетки этого корабля из woundedCells_; раненые до сих пор — потоплены сейчас
                 for (const auto& cell : ship.cells) {
-                    woundedCells_.erase(std::remove(woundedCells_.begin(), woundedCells_.end(), cell), woundedCells_.end());
+                    auto kept = std::remove(woundedCells_.begin(), woundedCells_.end(), cell);
+                    if (kept != woundedCells_.end()) sunkCells.push_back(cell);
+                    woundedCells_.erase(kept, woundedCells_.end());
                 }
             }
         }
+        propagateConstraints(x, y, true, false, sunkCells);
     } else if (board_->getBoard()[y][x] == 4) {  // Попали в мину
         currentLives_--;
         updateProbabilities(x, y, false, true);
+        propagateConstraints(x, y, false, true, {});
     } else {
         updateProbabilities(x, y, false, false);
+        propagateConstraints(x, y, false, false, {});
+    }
+    if (book_ && static_cast<int>(moveIndex_) <= book_->depth()) {
+        historyKey_ = OpeningBook::extendKey(historyKey_, y * board_->getSize() + x, classifyShot(*board_, x, y, hit));
     }
+    report_.elapsedMicros = micros();
     
     return hit;
 }
@@ -394,12 +685,12 @@ void BattleshipAlgorithm::updateProbabilities(int x, int y, bool hitShip, bool h
                     if (hitShip) {
                         // Увеличиваем вероятность корабля по горизонтали/вертикали вокруг попадания
                         if ((dx == 0 && dy != 0) || (dx != 0 && dy == 0)) {
-                            board_->updateProbabilities(nx, ny, false, false, factor * 0.7);
+                            board_->updateProbabilities(nx, ny, false, false, factor * params_.shipFactor);
                         }
                     }
                     if (hitMine) {
                         // Увеличиваем вероятность мины вокруг попадания
-                        board_->updateProbabilities(nx, ny, false, false, 0.0, factor * 0.3);
+                        board_->updateProbabilities(nx, ny, false, false, 0.0, factor * params_.mineFactor);
                     }
                 }
             }
@@ -407,6 +698,107 @@ void BattleshipAlgorithm::updateProbabilities(int x, int y, bool hitShip, bool h
     }
 }
 
+void BattleshipAlgorithm::propagateConstraints(int x, int y, bool hitShip, bool hitMine,
+                                               const std::vector<std::pair<int, int>>& sunkCells) {
+    int size = board_->getSize();
+    auto forNeighbors = [&](int cx, int cy, auto&& fn) {
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                int nx = cx + dx, ny = cy + dy;
+                if ((dx != 0 || dy != 0) && nx >= 0 && nx < size && ny >= 0 && ny < size) fn(nx, ny, dx != 0 && dy != 0);
+            }
+        }
+    };
+    // Рядом с палубой мин нет, по диагонали от неё нет и кораблей
+    if (hitShip) {
+        forNeighbors(x, y, [&](int nx, int ny, bool diagonal) {
+            noMine_[ny * size + nx] = 1;
+            if (diagonal) noShip_[ny * size + nx] = 1;
+        });
+    }
+    // Рядом с миной кораблей нет
+    if (hitMine) {
+        forNeighbors(x, y, [&](int nx, int ny, bool) { noShip_[ny * size + nx] = 1; });
+    }
+    // Вокруг потопленного корабля пусто
+    for (auto [cx, cy] : sunkCells) {
+        forNeighbors(cx, cy, [&](int nx, int ny, bool) {
+            noShip_[ny * size + nx] = 1;
+            noMine_[ny * size + nx] = 1;
+        });
+    }
+
+    // Эвристика updateProbabilities снова добавляет массу вокруг выстрела: радиус 2
+    // вокруг клеток радиуса 2, то есть не дальше kSpreadRadius. Вне этого окна и
+    // окрестностей потопленного корабля ни вероятности, ни маски не менялись, и
+    // выведенные нули там остались с прошлых ходов
+    const int kSpreadRadius = 4;
+    const auto& shots = board_->getShotsBoard();
+    auto restore = [&](int cx, int cy, bool) {
+        if (shots[cy][cx] != 0) return;
+        if (noShip_[cy * size + cx]) board_->setShipProbability(cx, cy, 0.0);
+        if (noMine_[cy * size + cx]) board_->setMineProbability(cx, cy, 0.0);
+    };
+    for (int cy = std::max(0, y - kSpreadRadius); cy <= std::min(size - 1, y + kSpreadRadius); ++cy) {
+        for (int cx = std::max(0, x - kSpreadRadius); cx <= std::min(size - 1, x + kSpreadRadius); ++cx) {
+            restore(cx, cy, false);
+        }
+    }
+    for (auto [cx, cy] : sunkCells) forNeighbors(cx, cy, restore);
+
+    // Вынужденная клетка: у раненого отрезка осталось единственное продолжение
+    if (woundedCells_.empty()) return;
+    int minX = size, maxX = -1, minY = size, maxY = -1;
+    for (auto [cx, cy] : woundedCells_) {
+        minX = std::min(minX, cx);
+        maxX = std::max(maxX, cx);
+        minY = std::min(minY, cy);
+        maxY = std::max(maxY, cy);
+    }
+    int count = static_cast<int>(woundedCells_.size());
+    bool horizontal = minY == maxY && maxX - minX + 1 == count;
+    bool vertical = minX == maxX && maxY - minY + 1 == count;
+    if (!horizontal && !vertical) return;  // раненых кораблей несколько
+    std::pair<int, int> ends[4] = {{minX - 1, minY}, {maxX + 1, minY}, {minX, minY - 1}, {minX, maxY + 1}};
+    int options = 0;
+    std::pair<int, int> forced = {-1, -1};
+    for (int i = 0; i < 4; ++i) {
+        // Отрезок из одной клетки продолжается в любую сторону, длинный — только вдоль себя
+        if (count > 1 && (i < 2) != horizontal) continue;
+        auto [ex, ey] = ends[i];
+        if (ex >= 0 && ex < size && ey >= 0 && ey < size && isHuntable(ex, ey)) {
+            options++;
+            forced = ends[i];
+        }
+    }
+    if (options == 1) board_->setShipProbability(forced.first, forced.second, 1.0);
+}
+
+bool BattleshipAlgorithm::isHuntable(int x, int y) const {
+    return board_->getShotsBoard()[y][x] == 0 && !noShip_[y * board_->getSize() + x];
+}
+
 int BattleshipAlgorithm::getCurrentLives() const {
     return currentLives_;
+}
+
+double BattleshipAlgorithm::getCurrentLambda() const {
+    return calculateRiskCoefficient();
+}
+
+const AlgorithmParams& BattleshipAlgorithm::getParams() const {
+    return params_;
+}
+
+std::pair<int, int> BattleshipAlgorithm::getLastMove() const {
+    return lastMove_;
+}
+
+const MoveReport& BattleshipAlgorithm::getLastReport() const {
+    return report_;
+}
+
+void BattleshipAlgorithm::setTrace(MoveTraceBuffer* trace, std::uint32_t gameId) {
+    trace_ = trace;
+    traceGame_ = gameId;
 } 
\ No newline at end of file
@@ -0,0 +1,188 @@
+#include "../include/BattleshipCApi.h"
+#include "../include/GameBoard.h"
+#include "../include/BattleshipAlgorithm.h"
+#include "../include/GameSetup.h"
+#include "../include/Simulation.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+struct bs_game {
+    std::shared_ptr<GameBoard> board;
+    std::unique_ptr<BattleshipAlgorithm> algorithm;
+    int maxLives;
+};
+
+namespace {
+
+int32_t readGrid(const bs_game* game, const std::vector<std::vector<double>>& grid, double* out, size_t count) {
+    int size = game->board->getSize();
+    if (count < static_cast<size_t>(size) * size) return BS_ERROR_BUFFER;
+    for (const auto& row : grid) {
+        out = std::copy(row.begin(), row.end(), out);
+    }
+    return BS_OK;
+}
+
+} // namespace
+
+extern "C" {
+
+int32_t bs_abi_version(void) {
+    return BS_ABI_VERSION;
+}
+
+bs_game* bs_game_create(int32_t size, int32_t max_lives) {
+    // max_lives делит текущие жизни в коэффициенте риска
+    if (size < 1 || max_lives < 1) return nullptr;
+    try {
+        auto game = std::make_unique<bs_game>();
+        game->board = std::make_shared<GameBoard>(size);
+        game->maxLives = max_lives;
+        return game.release();
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void bs_game_destroy(bs_game* game) {
+    delete game;
+}
+
+int32_t bs_game_load_layout(bs_game* game,
+                            const bs_ship* ships, size_t ship_count,
+                            const bs_cell* mines, size_t mine_count) {
+    if (!game || (ship_count && !ships) || (mine_count && !mines)) return BS_ERROR_ARGUMENT;
+    try {
+        game->algorithm.reset();
+        game->board->reset();
+        int size = game->board->getSize();
+        for (size_t i = 0; i < ship_count; ++i) {
+            const auto& ship = ships[i];
+            // placeShip не проверяет длину: неположительная испортила бы счёт оставшихся палуб
+            bool inRange = ship.length >= 1 && ship.length <= size && ship.x >= 0 && ship.x < size &&
+                           ship.y >= 0 && ship.y < size && (ship.horizontal == 0 || ship.horizontal == 1);
+            if (!inRange || !game->board->placeShip(ship.x, ship.y, ship.length, ship.horizontal != 0)) {
+                game->board->reset();
+                return BS_ERROR_LAYOUT;
+            }
+        }
+        for (size_t i = 0; i < mine_count; ++i) {
+            if (mines[i].x < 0 || mines[i].x >= size || mines[i].y < 0 || mines[i].y >= size ||
+                !game->board->placeMine(mines[i].x, mines[i].y)) {
+                game->board->reset();
+                return BS_ERROR_LAYOUT;
+            }
+        }
+        game->algorithm = std::make_unique<BattleshipAlgorithm>(game->board, game->maxLives);
+        return BS_OK;
+    } catch (...) {
+        return BS_ERROR_INTERNAL;
+    }
+}
+
+int32_t bs_game_step(bs_game* game, bs_move* move) {
+    if (!game || !move) return BS_ERROR_ARGUMENT;
+    if (!game->algorithm) return BS_ERROR_LAYOUT;
+    try {
+        if (bs_game_is_over(game)) return BS_GAME_OVER;
+        bool hit = game->algorithm->makeMove();
+        auto [x, y] = game->algorithm->getLastMove();
+        if (x == -1) return BS_GAME_OVER;
+        move->x = x;
+        move->y = y;
+        move->outcome = static_cast<int32_t>(classifyShot(*game->board, x, y, hit));
+        return BS_OK;
+    } catch (...) {
+        return BS_ERROR_INTERNAL;
+    }
+}
+
+int32_t bs_game_size(const bs_game* game) {
+    return game ? game->board->getSize() : BS_ERROR_ARGUMENT;
+}
+
+int32_t bs_game_lives(const bs_game* game) {
+    if (!game) return BS_ERROR_ARGUMENT;
+    return game->algorithm ? game->algorithm->getCurrentLives() : game->maxLives;
+}
+
+int32_t bs_game_remaining_ships(const bs_game* game) {
+    return game ? game->board->getRemainingShips() : BS_ERROR_ARGUMENT;
+}
+
+int32_t bs_game_is_over(const bs_game* game) {
+    if (!game) return BS_ERROR_ARGUMENT;
+    return (game->board->isVictory() || bs_game_lives(game) <= 0) ? 1 : 0;
+}
+
+int32_t bs_game_read_ship_probabilities(const bs_game* game, double* out, size_t count) {
+    if (!game || !out) return BS_ERROR_ARGUMENT;
+    return readGrid(game, game->board->getShipProbabilities(), out, count);
+}
+
+int32_t bs_game_read_mine_probabilities(const bs_game* game, double* out, size_t count) {
+    if (!game || !out) return BS_ERROR_ARGUMENT;
+    return readGrid(game, game->board->getMineProbabilities(), out, count);
+}
+
+int32_t bs_game_read_cells(const bs_game* game, int8_t* out, size_t count) {
+    if (!game || !out) return BS_ERROR_ARGUMENT;
+    int size = game->board->getSize();
+    if (count < static_cast<size_t>(size) * size) return BS_ERROR_BUFFER;
+    for (const auto& row : game->board->getBoard()) {
+        for (int cell : row) *out++ = static_cast<int8_t>(cell);
+    }
+    return BS_OK;
+}
+
+int32_t bs_run_games(int32_t size, const uint64_t* seeds, size_t count,
+                     int32_t threads, bs_game_result* results) {
+    if (size < 1 || threads < 0 || (count && (!seeds || !results))) return BS_ERROR_ARGUMENT;
+    try {
+        int workerCount = threads > 0 ? threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        workerCount = static_cast<int>(std::min<size_t>(workerCount, std::max<size_t>(count, 1)));
+        // Партии разной длины — раздаём их по одной через общий счётчик
+        std::atomic<size_t> next{0};
+        auto worker = [&]() {
+            Layout layout;
+            for (size_t i = next++; i < count; i = next++) {
+                bs_game_result& result = results[i];
+                result.seed = seeds[i];
+                result.moves = 0;
+                result.lives_left = 0;
+                result.victory = 0;
+                // Исключение из потока нельзя выпустить — оно убило бы процесс вызывающего
+                try {
+                    if (!generateRandomLayout(size, seeds[i], layout)) {
+                        result.status = BS_ERROR_LAYOUT;
+                        continue;
+                    }
+                    GameResult game = playGame(layout);
+                    result.moves = game.moves;
+                    result.lives_left = game.livesLeft;
+                    result.victory = game.victory ? 1 : 0;
+                    result.status = BS_OK;
+                } catch (...) {
+                    result.status = BS_ERROR_INTERNAL;
+                }
+            }
+        };
+        std::vector<std::thread> workers;
+        try {
+            for (int t = 1; t < workerCount; ++t) workers.emplace_back(worker);
+        } catch (const std::system_error&) {
+            // Не удалось создать поток — партии доиграют уже запущенные
+        }
+        worker();
+        for (auto& w : workers) w.join();
+        return BS_OK;
+    } catch (...) {
+        return BS_ERROR_INTERNAL;
+    }
+}
+
+} // extern "C"
@@ -0,0 +1,488 @@
+#include "../include/EndgameSolver.h"
+#include "../include/GameBoard.h"
+#include <algorithm>
+#include <bitset>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+int popcount(std::uint64_t word) {
+    return static_cast<int>(std::bitset<64>(word).count());
+}
+
+// Номер младшего установленного бита (word != 0)
+int lowestBit(std::uint64_t word) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+} // namespace
+
+EndgameSolver::EndgameSolver(int maxLayouts, int nodeBudget, int maxShips, int maxUnknown)
+    : maxLayouts_(maxLayouts), nodeBudget_(nodeBudget), maxShips_(maxShips), maxUnknown_(maxUnknown),
+      deadline_(std::chrono::steady_clock::time_point::max()), size_(0), words_(0),
+      mines_(0), cachedBoard_(nullptr), cachedSize_(0), enumerateNodes_(0), aborted_(false) {
+}
+
+const EndgameSolver::Stats& EndgameSolver::getLastStats() const {
+    return stats_;
+}
+
+std::size_t EndgameSolver::KeyHash::operator()(const std::vector<std::uint64_t>& key) const {
+    std::uint64_t hash = 1469598103934665603ULL;
+    for (auto word : key) {
+        hash ^= word + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    }
+    return static_cast<std::size_t>(hash);
+}
+
+bool EndgameSolver::test(const std::uint64_t* mask, int cell) const {
+    return (mask[cell >> 6] >> (cell & 63)) & 1;
+}
+
+void EndgameSolver::set(std::uint64_t* mask, int cell) const {
+    mask[cell >> 6] |= std::uint64_t(1) << (cell & 63);
+}
+
+void EndgameSolver::clear(std::uint64_t* mask, int cell) const {
+    mask[cell >> 6] &= ~(std::uint64_t(1) << (cell & 63));
+}
+
+double EndgameSolver::weight(const Entry& entry, int minesHit) const {
+    // C(free, r) — число раскладок оставшихся мин по свободным клеткам
+    int r = mines_ - minesHit;
+    if (r < 0 || entry.free < r) return 0.0;
+    double result = 1.0;
+    for (int i = 1; i <= r; ++i) {
+        result = result * (entry.free - r + i) / i;
+    }
+    return result;
+}
+
+bool EndgameSolver::setup(const GameBoard& board) {
+    // Дешёвая проверка эндшпиля до любых проходов по полю
+    lengths_.clear();
+    for (const auto& ship : board.getShips()) {
+        if (!ship.isSunk(board.getBoardInternal())) lengths_.push_back(static_cast<int>(ship.cells.size()));
+    }
+    if (lengths_.empty()) return false;
+    if (static_cast<int>(lengths_.size()) > maxShips_) {
+        stats_.skipped = true;
+        return false;
+    }
+    std::sort(lengths_.begin(), lengths_.end(), std::greater<int>());
+
+    size_ = board.getSize();
+    int cells = size_ * size_;
+    words_ = (cells + 63) / 64;
+    unknown_.assign(words_, 0);
+    wounded_.assign(words_, 0);
+    blocked_.assign(words_, 0);
+
+    const auto& state = board.getBoard();
+    const auto& shots = board.getShotsBoard();
+    std::vector<char> sunk(cells, 0);
+    for (const auto& ship : board.getShips()) {
+        if (ship.isSunk(board.getBoardInternal())) {
+            for (auto [x, y] : ship.cells) sunk[y * size_ + x] = 1;
+        }
+    }
+
+    int detonated = 0;
+    int unknownCount = 0;
+    for (int y = 0; y < size_; ++y) {
+        for (int x = 0; x < size_; ++x) {
+            int cell = y * size_ + x;
+            if (shots[y][x] == 0 && state[y][x] != 5) {
+                set(unknown_.data(), cell);
+                unknownCount++;
+            }
+            if (shots[y][x] != 0 && state[y][x] == 3 && !sunk[cell]) set(wounded_.data(), cell);
+            if (state[y][x] == 4) {
+                // Мины не ставятся рядом с кораблями
+                detonated++;
+                for (int ny = std::max(0, y - 1); ny <= std::min(size_ - 1, y + 1); ++ny) {
+                    for (int nx = std::max(0, x - 1); nx <= std::min(size_ - 1, x + 1); ++nx) {
+                        set(blocked_.data(), ny * size_ + nx);
+                    }
+                }
+            }
+        }
+    }
+    if (unknownCount > maxUnknown_) {
+        stats_.skipped = true;
+        return false;
+    }
+    mines_ = board.getRemainingMines() - detonated;
+    updatePlacements(board);
+    return true;
+}
+
+void EndgameSolver::updatePlacements(const GameBoard& board) {
+    // Клетки, где непотопленного корабля уже быть не может; за партию их только прибавляется
+    std::vector<std::uint64_t> excluded(words_);
+    for (int w = 0; w < words_; ++w) excluded[w] = ~(unknown_[w] | wounded_[w]) | blocked_[w];
+
+    bool rebuild = cachedBoard_ != &board || cachedSize_ != size_;
+    for (int w = 0; w < words_ && !rebuild; ++w) {
+        // Исключённая клетка снова открыта — это уже другая партия на том же поле
+        if (excluded_[w] & ~excluded[w]) rebuild = true;
+    }
+    for (int length : lengths_) {
+        if (std::find(cachedLengths_.begin(), cachedLengths_.end(), length) == cachedLengths_.end()) rebuild = true;
+    }
+    if (rebuild) {
+        cachedBoard_ = &board;
+        cachedSize_ = size_;
+        excluded_ = std::move(excluded);
+        buildPlacements();
+        return;
+    }
+
+    // Прореживание: убираем положения на новых исключённых клетках и длины потопленных кораблей
+    std::vector<std::uint64_t> fresh(words_);
+    bool changed = false;
+    for (int w = 0; w < words_; ++w) {
+        fresh[w] = excluded[w] & ~excluded_[w];
+        changed = changed || fresh[w] != 0;
+    }
+    std::vector<int> alive;
+    for (int length : cachedLengths_) {
+        if (std::find(lengths_.begin(), lengths_.end(), length) != lengths_.end()) alive.push_back(length);
+    }
+    changed = changed || alive.size() != cachedLengths_.size();
+    if (!changed) return;
+    cachedLengths_ = std::move(alive);
+    excluded_ = std::move(excluded);
+
+    size_t kept = 0;
+    for (size_t p = 0; p < placementLength_.size(); ++p) {
+        const std::uint64_t* pc = &placementCells_[p * words_];
+        bool valid = std::find(cachedLengths_.begin(), cachedLengths_.end(), placementLength_[p]) !=
+                     cachedLengths_.end();
+        for (int w = 0; w < words_ && valid; ++w) valid = (pc[w] & fresh[w]) == 0;
+        if (!valid) continue;
+        // Порядок положений сохраняется — перебор идёт так же, как после полной перестройки
+        if (kept != p) {
+            placementLength_[kept] = placementLength_[p];
+            std::copy(pc, pc + words_, &placementCells_[kept * words_]);
+            std::copy(&placementHalo_[p * words_], &placementHalo_[(p + 1) * words_], &placementHalo_[kept * words_]);
+        }
+        kept++;
+    }
+    placementLength_.resize(kept);
+    placementCells_.resize(kept * words_);
+    placementHalo_.resize(kept * words_);
+}
+
+void EndgameSolver::buildPlacements() {
+    // Все положения кораблей нужных длин по клеткам без информации и раненым
+    cachedLengths_.clear();
+    placementLength_.clear();
+    placementCells_.clear();
+    placementHalo_.clear();
+    for (size_t i = 0; i < lengths_.size(); ++i) {
+        int length = lengths_[i];
+        if (i > 0 && lengths_[i - 1] == length) continue;
+        cachedLengths_.push_back(length);
+        for (int horizontal = 1; horizontal >= (length == 1 ? 1 : 0); --horizontal) {
+            for (int y = 0; y < size_; ++y) {
+                for (int x = 0; x < size_; ++x) {
+                    if ((horizontal && x + length > size_) || (!horizontal && y + length > size_)) continue;
+                    size_t offset = placementCells_.size();
+                    placementCells_.resize(offset + words_, 0);
+                    placementHalo_.resize(offset + words_, 0);
+                    bool valid = true;
+                    for (int d = 0; d < length && valid; ++d) {
+                        int cx = horizontal ? x + d : x;
+                        int cy = horizontal ? y : y + d;
+                        int cell = cy * size_ + cx;
+                        valid = !test(excluded_.data(), cell);
+                        set(&placementCells_[offset], cell);
+                        for (int ny = std::max(0, cy - 1); ny <= std::min(size_ - 1, cy + 1); ++ny) {
+                            for (int nx = std::max(0, cx - 1); nx <= std::min(size_ - 1, cx + 1); ++nx) {
+                                set(&placementHalo_[offset], ny * size_ + nx);
+                            }
+                        }
+                    }
+                    if (valid) {
+                        placementLength_.push_back(length);
+                    } else {
+                        placementCells_.resize(offset);
+                        placementHalo_.resize(offset);
+                    }
+                }
+            }
+        }
+    }
+}
+
+bool EndgameSolver::expired() {
+    if (deadline_ == std::chrono::steady_clock::time_point::max()) return false;
+    if (std::chrono::steady_clock::now() >= deadline_) {
+        stats_.timedOut = true;
+        aborted_ = true;
+    }
+    return stats_.timedOut;
+}
+
+void EndgameSolver::enumerate(std::size_t ship, int minPlacement) {
+    if (aborted_) return;
+    if (++enumerateNodes_ > nodeBudget_) {
+        aborted_ = true;
+        return;
+    }
+    // Узлы перебора расстановок дешёвые — часы опрашиваются раз в kDeadlineInterval узлов
+    if (enumerateNodes_ % kDeadlineInterval == 0 && expired()) return;
+    // Клетки и окрестность уже поставленных кораблей лежат в стеке по глубине
+    const std::uint64_t* cells = &enumerateStack_[ship * 2 * words_];
+    const std::uint64_t* halo = cells + words_;
+    if (ship == lengths_.size()) {
+        int free = 0;
+        for (int w = 0; w < words_; ++w) {
+            if (wounded_[w] & ~cells[w]) return;  // раненая клетка осталась без корабля
+            free += popcount(unknown_[w] & ~halo[w]);
+        }
+        if (free < mines_) return;
+        if (static_cast<int>(layoutFree_.size()) == maxLayouts_) {
+            aborted_ = true;
+            return;
+        }
+        layoutCells_.insert(layoutCells_.end(), cells, cells + words_);
+        layoutHalo_.insert(layoutHalo_.end(), halo, halo + words_);
+        layoutShips_.insert(layoutShips_.end(), chosen_.begin(), chosen_.end());
+        layoutFree_.push_back(free);
+        return;
+    }
+    std::uint64_t* nextCells = &enumerateStack_[(ship + 1) * 2 * words_];
+    std::uint64_t* nextHalo = nextCells + words_;
+    // Одинаковые корабли ставятся по возрастанию индекса положения, чтобы не считать перестановки
+    int first = (ship > 0 && lengths_[ship - 1] == lengths_[ship]) ? minPlacement : 0;
+    int placements = static_cast<int>(placementLength_.size());
+    for (int p = first; p < placements && !aborted_; ++p) {
+        if (placementLength_[p] != lengths_[ship]) continue;
+        const std::uint64_t* pc = &placementCells_[static_cast<size_t>(p) * words_];
+        const std::uint64_t* ph = &placementHalo_[static_cast<size_t>(p) * words_];
+        bool fits = true;
+        for (int w = 0; w < words_ && fits; ++w) fits = (pc[w] & halo[w]) == 0;
+        if (!fits) continue;
+        bool covered = true;
+        for (int w = 0; w < words_; ++w) {
+            nextCells[w] = cells[w] | pc[w];
+            nextHalo[w] = halo[w] | ph[w];
+            // Раненая клетка в окрестности, но не под кораблём, уже ничем не закроется
+            if (wounded_[w] & nextHalo[w] & ~nextCells[w]) covered = false;
+        }
+        if (!covered) continue;
+        chosen_.push_back(p);
+        enumerate(ship + 1, p + 1);
+        chosen_.pop_back();
+    }
+}
+
+double EndgameSolver::solve(const std::vector<Entry>& entries, int minesHit, int lives, int hitsLeft,
+                            int& bestCell) {
+    bestCell = -1;
+    double lossPenalty = static_cast<double>(size_) * size_;
+    if (lives <= 0) return lossPenalty;
+    if (hitsLeft == 0) return 0.0;
+    // Подзадачу задают подбитые клетки и оставшиеся расстановки: промахи и подрывы
+    // уже учтены в списке расстановок и числе свободных клеток
+    std::vector<std::uint64_t> key(hits_);
+    key.push_back(static_cast<std::uint64_t>(minesHit));
+    for (const auto& entry : entries) {
+        key.push_back(static_cast<std::uint64_t>(entry.layout) << 32 | static_cast<std::uint32_t>(entry.free));
+    }
+    auto found = memo_.find(key);
+    if (found != memo_.end()) {
+        bestCell = found->second.cell;
+        return found->second.value;
+    }
+    if (++stats_.nodes > nodeBudget_) {
+        aborted_ = true;
+        return 0.0;
+    }
+    // Узел решения дорогой (проход по всем расстановкам), поэтому часы — на каждом
+    if (expired()) return 0.0;
+
+    std::uint64_t* hits = hits_.data();
+    int shipCount = static_cast<int>(lengths_.size());
+    int cells = size_ * size_;
+    int remainingMines = mines_ - minesHit;
+    double total = 0.0;
+    std::vector<std::uint64_t> candidates(words_, 0);
+    for (const auto& entry : entries) {
+        total += weight(entry, minesHit);
+        const std::uint64_t* layoutCells = &layoutCells_[static_cast<size_t>(entry.layout) * words_];
+        for (int w = 0; w < words_; ++w) candidates[w] |= layoutCells[w] & unknown_[w] & ~hits[w];
+    }
+    // Вероятности попадания и подрыва для каждой клетки-кандидата
+    std::vector<double> hitWeight(cells, 0.0), mineWeight(cells, 0.0);
+    for (const auto& entry : entries) {
+        double layoutWeight = weight(entry, minesHit);
+        size_t layout = static_cast<size_t>(entry.layout);
+        const std::uint64_t* layoutCells = &layoutCells_[layout * words_];
+        const std::uint64_t* layoutHalo = &layoutHalo_[layout * words_];
+        for (int w = 0; w < words_; ++w) {
+            for (std::uint64_t bits = candidates[w] & layoutCells[w]; bits; bits &= bits - 1) {
+                hitWeight[w * 64 + lowestBit(bits)] += layoutWeight;
+            }
+            for (std::uint64_t bits = candidates[w] & ~layoutHalo[w]; bits; bits &= bits - 1) {
+                mineWeight[w * 64 + lowestBit(bits)] += layoutWeight * remainingMines / entry.free;
+            }
+        }
+    }
+    std::vector<int> order;
+    for (int c = 0; c < cells; ++c) {
+        if (!test(candidates.data(), c)) continue;
+        if (hitWeight[c] == total) {
+            // Клетка под кораблём в каждой расстановке: её всё равно придётся простреливать,
+            // а выстрел сейчас только добавляет информации
+            order.assign(1, c);
+            break;
+        }
+        order.push_back(c);
+    }
+    // Сначала вероятные попадания — хороший ход находится раньше и отсекает остальные
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return hitWeight[a] > hitWeight[b]; });
+
+    // Нижняя оценка: каждое оставшееся попадание стоит выстрела, подрыв на последней жизни — проигрыш
+    auto lowerBound = [&](int livesLeft, int hitsNeeded) {
+        return livesLeft <= 0 ? lossPenalty : static_cast<double>(hitsNeeded);
+    };
+
+    double best = lossPenalty * 2.0;
+    std::vector<Entry> miss, mine, hit;
+    std::vector<std::pair<int, std::vector<Entry>>> sunkGroups;
+    for (int c : order) {
+        if (aborted_) break;
+        double pHit = hitWeight[c] / total;
+        double pMine = mineWeight[c] / total;
+        double pMiss = 1.0 - pHit - pMine;
+        double pendingBound = pMiss * lowerBound(lives, hitsLeft) + pMine * lowerBound(lives - 1, hitsLeft) +
+                              pHit * lowerBound(lives, hitsLeft - 1);
+        if (1.0 + pendingBound >= best) continue;
+
+        miss.clear();
+        mine.clear();
+        hit.clear();
+        sunkGroups.clear();
+        for (const auto& entry : entries) {
+            size_t layout = static_cast<size_t>(entry.layout);
+            if (test(&layoutCells_[layout * words_], c)) {
+                int placement = -1;
+                for (int s = 0; s < shipCount && placement == -1; ++s) {
+                    int p = layoutShips_[layout * shipCount + s];
+                    if (test(&placementCells_[static_cast<size_t>(p) * words_], c)) placement = p;
+                }
+                // Корабль тонет, если все его клетки, кроме c, уже подбиты
+                bool sinks = true;
+                const std::uint64_t* pc = &placementCells_[static_cast<size_t>(placement) * words_];
+                for (int w = 0; w < words_ && sinks; ++w) {
+                    std::uint64_t rest = pc[w] & ~wounded_[w] & ~hits[w];
+                    if (w == (c >> 6)) rest &= ~(std::uint64_t(1) << (c & 63));
+                    sinks = rest == 0;
+                }
+                if (!sinks) {
+                    hit.push_back(entry);
+                } else {
+                    auto group = std::find_if(sunkGroups.begin(), sunkGroups.end(),
+                                              [&](const auto& g) { return g.first == placement; });
+                    if (group == sunkGroups.end()) {
+                        sunkGroups.push_back({placement, {}});
+                        group = sunkGroups.end() - 1;
+                    }
+                    group->second.push_back(entry);
+                }
+            } else if (!test(&layoutHalo_[layout * words_], c)) {
+                // Свободная клетка: мина или промах, свободных становится на одну меньше
+                Entry next{entry.layout, entry.free - 1};
+                if (weight(next, minesHit + 1) > 0.0) mine.push_back(next);
+                if (weight(next, minesHit) > 0.0) miss.push_back(next);
+            } else {
+                miss.push_back(entry);
+            }
+        }
+
+        // Исходы разбираются по очереди; как только точная часть плюс оценка
+        // оставшихся не лучше найденного хода, клетка отбрасывается
+        auto groupWeight = [&](const std::vector<Entry>& group, int hitMines) {
+            double sum = 0.0;
+            for (const auto& entry : group) sum += weight(entry, hitMines);
+            return sum / total;
+        };
+        auto branch = [&](const std::vector<Entry>& group, int hitMines, int livesLeft, int hitsNeeded, double p) {
+            int unused;
+            pendingBound -= p * lowerBound(livesLeft, hitsNeeded);
+            return p * solve(group, hitMines, livesLeft, hitsNeeded, unused);
+        };
+        double value = 1.0;
+        if (!miss.empty()) {
+            value += branch(miss, minesHit, lives, hitsLeft, groupWeight(miss, minesHit));
+        }
+        if (!mine.empty() && value + pendingBound < best) {
+            value += branch(mine, minesHit + 1, lives - 1, hitsLeft, groupWeight(mine, minesHit + 1));
+        }
+        set(hits, c);
+        if (!hit.empty() && value + pendingBound < best) {
+            value += branch(hit, minesHit, lives, hitsLeft - 1, groupWeight(hit, minesHit));
+        }
+        for (const auto& group : sunkGroups) {
+            if (value + pendingBound >= best) break;
+            value += branch(group.second, minesHit, lives, hitsLeft - 1, groupWeight(group.second, minesHit));
+        }
+        clear(hits, c);
+
+        if (value + pendingBound < best) {
+            best = value;
+            bestCell = c;
+        }
+    }
+    if (!aborted_) memo_[std::move(key)] = {best, bestCell};
+    return best;
+}
+
+std::pair<int, int> EndgameSolver::findMove(const GameBoard& board, int lives,
+                                            std::chrono::steady_clock::time_point deadline) {
+    stats_ = Stats();
+    aborted_ = false;
+    enumerateNodes_ = 0;
+    deadline_ = deadline;
+    layoutCells_.clear();
+    layoutHalo_.clear();
+    layoutShips_.clear();
+    layoutFree_.clear();
+    memo_.clear();
+    if (lives <= 0 || !setup(board)) return {-1, -1};
+    // Перестройка положений на большом поле сама может съесть срок
+    if (expired()) return {-1, -1};
+
+    enumerateStack_.assign((lengths_.size() + 1) * 2 * words_, 0);
+    chosen_.clear();
+    enumerate(0, 0);
+    int layouts = static_cast<int>(layoutFree_.size());
+    stats_.layouts = (aborted_ && !stats_.timedOut) ? maxLayouts_ + 1 : layouts;
+    if (aborted_ || layouts == 0) return {-1, -1};
+
+    std::vector<Entry> entries(layouts);
+    for (int i = 0; i < layouts; ++i) entries[i] = {i, layoutFree_[i]};
+    int hitsLeft = 0;
+    for (int length : lengths_) hitsLeft += length;
+    for (auto word : wounded_) hitsLeft -= popcount(word);
+
+    hits_.assign(words_, 0);
+    int cell = -1;
+    double value = solve(entries, 0, lives, hitsLeft, cell);
+    memo_.clear();
+    if (aborted_ || cell == -1) return {-1, -1};
+    stats_.solved = true;
+    stats_.expectedShots = value;
+    return {cell % size_, cell / size_};
+}
@@ -1,6 +1,7 @@
 #include "../include/GameBoard.h"
 #include <stdexcept>
 #include <algorithm>
+#include <cassert>
 #include <cmath>
 
 GameBoard::GameBoard(int size)
@@ -8,12 +9,61 @@ GameBoard::GameBoard(int size)
     , remainingShips_(0)               
     , remainingMines_(0)
     , board_(size, std::vector<int>(size, 0))
+    , neighborCounts_(size, std::vector<int>(size, 0))
     , shipProbabilities_(size, std::vector<double>(size, 0.0))
     , mineProbabilities_(size, std::vector<double>(size, 0.0))
     , shotsBoard_(size, std::vector<int>(size, 0))
 {
 }
 
+void GameBoard::reset() {
+    remainingShips_ = 0;
+    remainingMines_ = 0;
+    initialShipProb_ = 0.0;
+    initialMineProb_ = 0.0;
+    for (int y = 0; y < size_; ++y) {
+        std::fill(board_[y].begin(), board_[y].end(), 0);
+        std::fill(neighborCounts_[y].begin(), neighborCounts_[y].end(), 0);
+        std::fill(shipProbabilities_[y].begin(), shipProbabilities_[y].end(), 0.0);
+        std::fill(mineProbabilities_[y].begin(), mineProbabilities_[y].end(), 0.0);
+        std::fill(shotsBoard_[y].begin(), shotsBoard_[y].end(), 0);
+    }
+    // Корабли уходят в запас вместе с памятью под клетки, placeShip берёт их обратно
+    for (auto& ship : ships_) spareShips_.push_back(std::move(ship));
+    ships_.clear();
+}
+
+void GameBoard::setCell(int x, int y, int value) {
+    // Счётчики меняются, только когда клетка становится пустой или непустой
+    int delta = (value != 0) - (board_[y][x] != 0);
+    board_[y][x] = value;
+    if (delta == 0) return;
+    for (int ny = std::max(0, y - 1); ny <= std::min(size_ - 1, y + 1); ++ny) {
+        for (int nx = std::max(0, x - 1); nx <= std::min(size_ - 1, x + 1); ++nx) {
+            neighborCounts_[ny][nx] += delta;
+        }
+    }
+}
+
+int GameBoard::getNeighborCount(int x, int y) const {
+    return neighborCounts_[y][x];
+}
+
+bool GameBoard::checkNeighborCounts() const {
+    for (int y = 0; y < size_; ++y) {
+        for (int x = 0; x < size_; ++x) {
+            int count = 0;
+            for (int dx = -1; dx <= 1; ++dx) {
+                for (int dy = -1; dy <= 1; ++dy) {
+                    if (isValidPosition(x + dx, y + dy) && board_[y + dy][x + dx] != 0) count++;
+                }
+            }
+            if (count != neighborCounts_[y][x]) return false;
+        }
+    }
+    return true;
+}
+
 bool GameBoard::isValidPosition(int x, int y) const {
     return x >= 0 && x < size_ && y >= 0 && y < size_;
 }
@@ -45,14 +95,20 @@ bool GameBoard::placeShip(int x, int y, int length, bool horizontal) {
         return false;
     }
     Ship newShip;
+    if (!spareShips_.empty()) {
+        newShip = std::move(spareShips_.back());
+        spareShips_.pop_back();
+        newShip.cells.clear();
+    }
     for (int i = 0; i < length; ++i) {
         int shipX = horizontal ? x + i : x;
         int shipY = horizontal ? y : y + i;
-        board_[shipY][shipX] = 1;
+        setCell(shipX, shipY, 1);
         newShip.cells.push_back({shipX, shipY});
     }
-    ships_.push_back(newShip);
+    ships_.push_back(std::move(newShip));
     remainingShips_ += length;
+    assert(checkNeighborCounts());
     return true;
 }
 
@@ -76,8 +132,9 @@ bool GameBoard::placeMine(int x, int y) {
         return false;
     }
     
-    board_[y][x] = 2;
+    setCell(x, y, 2);
     remainingMines_++;
+    assert(checkNeighborCounts());
     return true;
 }
 
@@ -87,7 +144,7 @@ bool GameBoard::makeShot(int x, int y) {
     }
     shotsBoard_[y][x] = 1;
     if (board_[y][x] == 1) {
-        board_[y][x] = 3;  // Пораженный корабль
+        setCell(x, y, 3);  // Пораженный корабль
         remainingShips_--;
         // Проверяем, потоплен ли корабль
         for (auto& ship : ships_) {
@@ -103,12 +160,14 @@ bool GameBoard::makeShot(int x, int y) {
                 }
             }
         }
+        assert(checkNeighborCounts());
         return true;
     } else if (board_[y][x] == 2) {
-        board_[y][x] = 4;  // Сработавшая мина
+        setCell(x, y, 4);  // Сработавшая мина
     } else if (board_[y][x] == 0) {
-        board_[y][x] = 5;  // Промах
+        setCell(x, y, 5);  // Промах
     }
+    assert(checkNeighborCounts());
     return false;
 }
 
@@ -204,6 +263,14 @@ void GameBoard::updateProbabilities(int x, int y, bool hitShip, bool hitMine,
     }
 }
 
+void GameBoard::setShipProbability(int x, int y, double prob) {
+    shipProbabilities_[y][x] = prob;
+}
+
+void GameBoard::setMineProbability(int x, int y, double prob) {
+    mineProbabilities_[y][x] = prob;
+}
+
 void GameBoard::markSurroundingCells(const Ship& ship) {
     for (auto [x, y] : ship.cells) {
         for (int dx = -1; dx <= 1; ++dx) {
@@ -211,7 +278,7 @@ void GameBoard::markSurroundingCells(const Ship& ship) {
                 int nx = x + dx;
                 int ny = y + dy;
                 if (isValidPosition(nx, ny) && board_[ny][nx] == 0) {
-                    board_[ny][nx] = 5; // 5 — промах/пустая клетка
+                    setCell(nx, ny, 5); // 5 — промах/пустая клетка
                 }
             }
         }
@@ -0,0 +1,279 @@
+#include "../include/GameRecord.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+const char kMagic[4] = {'B', 'S', 'G', 'R'};
+const std::uint32_t kVersion = 2;
+const unsigned char kFlagVictory = 1;
+const unsigned char kFlagLayoutOnly = 2;
+const std::size_t kFileHeaderSize = 8;
+
+void putVarint(std::vector<unsigned char>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+// Возвращает false, если varint выходит за границу буфера
+bool getVarint(const unsigned char*& pos, const unsigned char* end, std::uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && pos < end; shift += 7) {
+        unsigned char byte = *pos++;
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+std::uint64_t zigzag(std::int64_t value) {
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+std::int64_t unzigzag(std::uint64_t value) {
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+[[noreturn]] void corrupt(std::size_t offset) {
+    throw std::runtime_error("Corrupt game record at offset " + std::to_string(offset));
+}
+
+} // namespace
+
+bool GameRecordView::MoveCursor::next(MoveRecord& move) {
+    if (remaining_ <= 0) return false;
+    std::uint64_t packed;
+    if (!getVarint(pos_, end_, packed)) {
+        throw std::runtime_error("Truncated move stream");
+    }
+    int cell = prevCell_ + static_cast<int>(unzigzag(packed >> 2));
+    if (cell < 0 || cell >= size_ * size_) {
+        throw std::runtime_error("Move outside of the board");
+    }
+    prevCell_ = cell;
+    move.x = cell % size_;
+    move.y = cell / size_;
+    move.outcome = static_cast<ShotOutcome>(packed & 3);
+    --remaining_;
+    return true;
+}
+
+const GameRecordHeader& GameRecordView::header() const {
+    return header_;
+}
+
+void GameRecordView::readLayout(Layout& layout) const {
+    layout.size = header_.size;
+    layout.ships.clear();
+    layout.mines.clear();
+    std::uint64_t cells = static_cast<std::uint64_t>(header_.size) * header_.size;
+    const unsigned char* pos = ships_;
+    std::uint64_t cell, packed;
+    for (int i = 0; i < header_.shipCount; ++i) {
+        if (!getVarint(pos, mines_, cell) || !getVarint(pos, mines_, packed) || cell >= cells ||
+            (packed >> 1) < 1 || (packed >> 1) > static_cast<std::uint64_t>(header_.size)) {
+            throw std::runtime_error("Corrupt ship in game record");
+        }
+        layout.ships.push_back({static_cast<int>(cell % header_.size), static_cast<int>(cell / header_.size),
+                                static_cast<int>(packed >> 1), (packed & 1) != 0});
+    }
+    pos = mines_;
+    std::uint64_t mineCell = 0, delta;
+    for (int i = 0; i < header_.mineCount; ++i) {
+        if (!getVarint(pos, moves_, delta) || delta >= cells - mineCell) {
+            throw std::runtime_error("Corrupt mine in game record");
+        }
+        mineCell += delta;
+        layout.mines.push_back({static_cast<int>(mineCell % header_.size), static_cast<int>(mineCell / header_.size)});
+    }
+}
+
+GameRecordView::MoveCursor GameRecordView::moves() const {
+    MoveCursor cursor;
+    cursor.pos_ = moves_;
+    cursor.end_ = end_;
+    cursor.size_ = header_.size;
+    cursor.remaining_ = header_.moveCount;
+    return cursor;
+}
+
+GameRecordReader::GameRecordReader(const std::string& path)
+    : file_(path)
+    , offset_(kFileHeaderSize)
+{
+    std::uint32_t version = 0;
+    if (file_.size() < kFileHeaderSize || std::memcmp(file_.data(), kMagic, 4) != 0) {
+        throw std::runtime_error("Not a game record file: " + path);
+    }
+    std::memcpy(&version, file_.data() + 4, sizeof(version));
+    if (version < 1 || version > kVersion) {
+        throw std::runtime_error("Unsupported game record version in " + path);
+    }
+}
+
+bool GameRecordReader::next(GameRecordView& view) {
+    const unsigned char* base = file_.data();
+    const unsigned char* fileEnd = base + file_.size();
+    const unsigned char* pos = base + offset_;
+    if (pos >= fileEnd) return false;
+
+    std::size_t recordOffset = offset_;
+    std::uint64_t length;
+    if (!getVarint(pos, fileEnd, length) || length > static_cast<std::uint64_t>(fileEnd - pos)) {
+        corrupt(recordOffset);
+    }
+    const unsigned char* end = pos + length;
+    // Граница записи известна — дальше можно читать, даже если её тело испорчено
+    offset_ = static_cast<std::size_t>(end - base);
+
+    std::uint64_t value;
+    GameRecordHeader& header = view.header_;
+    auto read = [&](std::uint64_t& out) {
+        if (!getVarint(pos, end, out)) corrupt(recordOffset);
+    };
+    read(value); header.size = static_cast<int>(value);
+    read(header.seed);
+    read(value); header.maxLives = static_cast<int>(value);
+    read(value); header.livesLeft = static_cast<int>(value);
+    if (pos >= end) corrupt(recordOffset);
+    unsigned char flags = *pos++;
+    header.victory = (flags & kFlagVictory) != 0;
+    header.layoutOnly = (flags & kFlagLayoutOnly) != 0;
+    if (header.size <= 0) corrupt(recordOffset);
+
+    read(value); header.shipCount = static_cast<int>(value);
+    view.ships_ = pos;
+    for (int i = 0; i < 2 * header.shipCount; ++i) read(value);
+
+    read(value); header.mineCount = static_cast<int>(value);
+    view.mines_ = pos;
+    for (int i = 0; i < header.mineCount; ++i) read(value);
+
+    read(value); header.moveCount = static_cast<int>(value);
+    if (header.layoutOnly && header.moveCount != 0) corrupt(recordOffset);
+    view.moves_ = pos;
+    view.end_ = end;
+    return true;
+}
+
+std::size_t GameRecordReader::offset() const {
+    return offset_;
+}
+
+GameRecordWriter::GameRecordWriter(const std::string& path, bool truncate)
+    : file_(truncate ? nullptr : std::fopen(path.c_str(), "r+b"))
+{
+    // Дописывать можно только в архив не новее нашего формата
+    if (file_) {
+        std::fseek(file_, 0, SEEK_END);
+        if (std::ftell(file_) > 0) {
+            char magic[4] = {};
+            std::uint32_t version = 0;
+            std::fseek(file_, 0, SEEK_SET);
+            bool valid = std::fread(magic, 1, sizeof(magic), file_) == sizeof(magic) &&
+                         std::fread(&version, sizeof(version), 1, file_) == 1 &&
+                         std::memcmp(magic, kMagic, 4) == 0 && version >= 1 && version <= kVersion;
+            if (!valid) {
+                std::fclose(file_);
+                throw std::runtime_error("Cannot append to " + path + ": not a game record file of version 1.." +
+                                         std::to_string(kVersion));
+            }
+            // Записи старых версий читаются и по текущей, поэтому достаточно поднять версию
+            if (version < kVersion) {
+                std::fseek(file_, 4, SEEK_SET);
+                std::fwrite(&kVersion, sizeof(kVersion), 1, file_);
+            }
+            std::fseek(file_, 0, SEEK_END);
+            return;
+        }
+    } else {
+        file_ = std::fopen(path.c_str(), "wb");
+    }
+    if (!file_) {
+        throw std::runtime_error("Cannot open file for writing: " + path);
+    }
+    std::fwrite(kMagic, 1, sizeof(kMagic), file_);
+    std::fwrite(&kVersion, sizeof(kVersion), 1, file_);
+}
+
+GameRecordWriter::~GameRecordWriter() {
+    std::fclose(file_);
+}
+
+void GameRecordWriter::encode(std::vector<unsigned char>& out, const Layout& layout, std::uint64_t seed,
+                              int maxLives, const GameResult& result, const std::vector<MoveRecord>& moves) {
+    encodeRecord(out, layout, seed, maxLives, result.livesLeft, result.victory ? kFlagVictory : 0, moves);
+}
+
+void GameRecordWriter::encodeLayout(std::vector<unsigned char>& out, const Layout& layout, std::uint64_t seed,
+                                    int maxLives) {
+    static const std::vector<MoveRecord> kNoMoves;
+    encodeRecord(out, layout, seed, maxLives, 0, kFlagLayoutOnly, kNoMoves);
+}
+
+void GameRecordWriter::encodeRecord(std::vector<unsigned char>& out, const Layout& layout, std::uint64_t seed,
+                                    int maxLives, int livesLeft, unsigned char flags,
+                                    const std::vector<MoveRecord>& moves) {
+    thread_local std::vector<unsigned char> body;
+    thread_local std::vector<int> mineCells;
+    body.clear();
+    mineCells.clear();
+
+    int size = layout.size;
+    putVarint(body, static_cast<std::uint64_t>(size));
+    putVarint(body, seed);
+    putVarint(body, static_cast<std::uint64_t>(maxLives));
+    putVarint(body, static_cast<std::uint64_t>(livesLeft));
+    body.push_back(flags);
+
+    putVarint(body, layout.ships.size());
+    for (const auto& ship : layout.ships) {
+        putVarint(body, static_cast<std::uint64_t>(ship.y * size + ship.x));
+        putVarint(body, (static_cast<std::uint64_t>(ship.length) << 1) | (ship.horizontal ? 1 : 0));
+    }
+
+    for (auto [x, y] : layout.mines) mineCells.push_back(y * size + x);
+    std::sort(mineCells.begin(), mineCells.end());
+    putVarint(body, mineCells.size());
+    int prevMine = 0;
+    for (int cell : mineCells) {
+        putVarint(body, static_cast<std::uint64_t>(cell - prevMine));
+        prevMine = cell;
+    }
+
+    putVarint(body, moves.size());
+    int prevCell = 0;
+    for (const auto& move : moves) {
+        int cell = move.y * size + move.x;
+        putVarint(body, (zigzag(cell - prevCell) << 2) | static_cast<std::uint64_t>(move.outcome));
+        prevCell = cell;
+    }
+
+    putVarint(out, body.size());
+    out.insert(out.end(), body.begin(), body.end());
+}
+
+void GameRecordWriter::append(const Layout& layout, std::uint64_t seed, int maxLives,
+                              const GameResult& result, const std::vector<MoveRecord>& moves) {
+    // Кодируем вне блокировки в буфер потока, под мьютексом — только одна запись в файл
+    thread_local std::vector<unsigned char> record;
+    record.clear();
+    encode(record, layout, seed, maxLives, result, moves);
+    appendEncoded(record);
+}
+
+void GameRecordWriter::appendEncoded(const std::vector<unsigned char>& records) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (std::fwrite(records.data(), 1, records.size(), file_) != records.size()) {
+        throw std::runtime_error("Failed to write game record");
+    }
+}
+
+void GameRecordWriter::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::fflush(file_);
+}
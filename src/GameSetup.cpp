@@ -0,0 +1,142 @@
+#include "../include/GameSetup.h"
+#include "../include/GameBoard.h"
+#include <cmath>
+#include <random>
+
+int calculateShipCount(int size) {
+    // По формуле из ReadMe: K = ⌊(20/100) * N²⌋
+    return static_cast<int>(std::floor(0.2 * size * size));
+}
+
+int calculateMineCount(int size) {
+    // По формуле из ReadMe: M = ⌊0.03 * N²⌋
+    return static_cast<int>(std::floor(0.03 * size * size));
+}
+
+std::vector<ShipType> calculateFleet(int size) {
+    int area = size * size;
+    int totalDecks = static_cast<int>(area * 0.2 + 0.5); // 20% of area, rounded
+    std::vector<ShipType> baseFleet = {
+        {4, 1}, {3, 2}, {2, 3}
+    };
+    int usedDecks = 0;
+    std::vector<ShipType> fleet;
+    int scale = size / 10;
+    if (scale < 1) scale = 1;
+    // Масштабируем флот
+    for (auto ship : baseFleet) {
+        int newCount = ship.count * scale;
+        int newLength = ship.length * scale;
+        if (newLength > size) newLength = size;
+        fleet.push_back({newLength, newCount});
+        usedDecks += newCount * newLength;
+    }
+    // Остаток — однопалубные
+    int singleShips = totalDecks - usedDecks;
+    if (singleShips > 0) {
+        fleet.push_back({1, singleShips});
+    }
+    return fleet;
+}
+
+namespace {
+
+// Ставит корабль в случайную допустимую позицию: сначала случайные пробы,
+// затем полный перебор позиций с случайного смещения
+bool placeRandomShip(GameBoard& board, int length, std::mt19937_64& rng, ShipPlacement& placed) {
+    int size = board.getSize();
+    std::uniform_int_distribution<int> coord(0, size - 1);
+    std::bernoulli_distribution orientation(0.5);
+    for (int attempt = 0; attempt < 100; ++attempt) {
+        int x = coord(rng);
+        int y = coord(rng);
+        bool horizontal = orientation(rng);
+        if (board.placeShip(x, y, length, horizontal)) {
+            placed = {x, y, length, horizontal};
+            return true;
+        }
+    }
+    int cells = size * size;
+    int start = std::uniform_int_distribution<int>(0, cells - 1)(rng);
+    bool firstHorizontal = orientation(rng);
+    for (int i = 0; i < cells; ++i) {
+        int cell = (start + i) % cells;
+        int x = cell % size;
+        int y = cell / size;
+        for (int k = 0; k < 2; ++k) {
+            bool horizontal = (k == 0) == firstHorizontal;
+            if (board.placeShip(x, y, length, horizontal)) {
+                placed = {x, y, length, horizontal};
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool placeRandomMine(GameBoard& board, std::mt19937_64& rng, std::pair<int, int>& placed) {
+    int size = board.getSize();
+    std::uniform_int_distribution<int> coord(0, size - 1);
+    for (int attempt = 0; attempt < 100; ++attempt) {
+        int x = coord(rng);
+        int y = coord(rng);
+        if (board.placeMine(x, y)) {
+            placed = {x, y};
+            return true;
+        }
+    }
+    int cells = size * size;
+    int start = std::uniform_int_distribution<int>(0, cells - 1)(rng);
+    for (int i = 0; i < cells; ++i) {
+        int cell = (start + i) % cells;
+        if (board.placeMine(cell % size, cell / size)) {
+            placed = {cell % size, cell / size};
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+bool generateRandomLayout(int size, std::uint64_t seed, Layout& layout) {
+    std::mt19937_64 rng(seed);
+    GameBoard board(size);
+    auto fleet = calculateFleet(size);
+    int totalMines = calculateMineCount(size);
+    // Плотная расстановка иногда заходит в тупик — тогда начинаем заново
+    for (int restart = 0; restart < 100; ++restart) {
+        board.reset();
+        layout.size = size;
+        layout.ships.clear();
+        layout.mines.clear();
+        bool ok = true;
+        for (const auto& type : fleet) {
+            for (int i = 0; i < type.count && ok; ++i) {
+                ShipPlacement placed;
+                ok = placeRandomShip(board, type.length, rng, placed);
+                if (ok) layout.ships.push_back(placed);
+            }
+            if (!ok) break;
+        }
+        for (int i = 0; i < totalMines && ok; ++i) {
+            std::pair<int, int> mine;
+            ok = placeRandomMine(board, rng, mine);
+            if (ok) layout.mines.push_back(mine);
+        }
+        if (ok) return true;
+    }
+    return false;
+}
+
+bool applyLayout(GameBoard& board, const Layout& layout) {
+    if (board.getSize() != layout.size) return false;
+    board.reset();
+    for (const auto& ship : layout.ships) {
+        if (!board.placeShip(ship.x, ship.y, ship.length, ship.horizontal)) return false;
+    }
+    for (auto [x, y] : layout.mines) {
+        if (!board.placeMine(x, y)) return false;
+    }
+    return true;
+}
@@ -0,0 +1,315 @@
+#include "../include/LayoutLoader.h"
+#include "../include/GameBoard.h"
+#include "../include/GameRecord.h"
+#include "../include/MappedFile.h"
+#include "../include/Simulation.h"
+#include "../include/ThreadPool.h"
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+
+namespace {
+
+// Кусок файла, который проверяет одна задача; граница всегда после перевода строки
+const std::size_t kChunkBytes = 1 << 20;
+// Числа в файле не больше этого, чтобы разбор не переполнялся
+const int kMaxNumber = 1000000;
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t';
+}
+
+void skipSpaces(const char*& pos, const char* end) {
+    while (pos < end && isSpace(*pos)) ++pos;
+}
+
+bool parseNumber(const char*& pos, const char* end, int& value) {
+    if (pos == end || *pos < '0' || *pos > '9') return false;
+    value = 0;
+    while (pos < end && *pos >= '0' && *pos <= '9') {
+        value = value * 10 + (*pos++ - '0');
+        if (value > kMaxNumber) return false;
+    }
+    return true;
+}
+
+std::string describeShip(const ShipPlacement& ship) {
+    return "ship at " + std::to_string(ship.x) + "," + std::to_string(ship.y) + " of length " +
+           std::to_string(ship.length) + (ship.horizontal ? " (horizontal)" : " (vertical)");
+}
+
+std::string describeMine(int x, int y) {
+    return "mine at " + std::to_string(x) + "," + std::to_string(y);
+}
+
+// Результат проверки одного куска; выводится по порядку, когда готовы все предыдущие
+struct ChunkResult {
+    std::vector<unsigned char> records;
+    std::string errors;
+    LayoutLoadStats stats;
+    bool done = false;
+};
+
+} // namespace
+
+bool parseLayoutLine(const char* begin, const char* end, Layout& layout, int& column, std::string& message,
+                     std::vector<int>* itemColumns) {
+    const char* pos = begin;
+    auto fail = [&](const char* at, const char* text) {
+        column = static_cast<int>(at - begin) + 1;
+        message = text;
+        return false;
+    };
+    layout.ships.clear();
+    layout.mines.clear();
+    if (itemColumns) itemColumns->clear();
+
+    skipSpaces(pos, end);
+    if (!parseNumber(pos, end, layout.size)) return fail(pos, "expected board size");
+    skipSpaces(pos, end);
+    if (pos == end || *pos != ':') return fail(pos, "expected ':' after board size");
+    ++pos;
+
+    // Корабли до ';'
+    while (true) {
+        skipSpaces(pos, end);
+        if (pos == end) return fail(pos, "expected ';' before mines");
+        if (*pos == ';') {
+            ++pos;
+            break;
+        }
+        const char* start = pos;
+        ShipPlacement ship;
+        if (!parseNumber(pos, end, ship.x)) return fail(pos, "expected ship x");
+        if (pos == end || *pos++ != ',') return fail(pos - 1, "expected ',' after ship x");
+        if (!parseNumber(pos, end, ship.y)) return fail(pos, "expected ship y");
+        if (pos == end || *pos++ != ',') return fail(pos - 1, "expected ',' after ship y");
+        if (!parseNumber(pos, end, ship.length)) return fail(pos, "expected ship length");
+        if (pos == end || (*pos != 'h' && *pos != 'v')) return fail(pos, "expected 'h' or 'v' after ship length");
+        ship.horizontal = *pos++ == 'h';
+        if (pos != end && !isSpace(*pos) && *pos != ';') return fail(pos, "expected space after ship");
+        layout.ships.push_back(ship);
+        if (itemColumns) itemColumns->push_back(static_cast<int>(start - begin) + 1);
+    }
+
+    // Мины до конца строки
+    while (true) {
+        skipSpaces(pos, end);
+        if (pos == end) break;
+        const char* start = pos;
+        int x, y;
+        if (!parseNumber(pos, end, x)) return fail(pos, "expected mine x");
+        if (pos == end || *pos++ != ',') return fail(pos - 1, "expected ',' after mine x");
+        if (!parseNumber(pos, end, y)) return fail(pos, "expected mine y");
+        if (pos != end && !isSpace(*pos)) return fail(pos, "expected space after mine");
+        layout.mines.emplace_back(x, y);
+        if (itemColumns) itemColumns->push_back(static_cast<int>(start - begin) + 1);
+    }
+    return true;
+}
+
+void appendLayoutLine(std::string& out, const Layout& layout) {
+    out += std::to_string(layout.size);
+    out += ':';
+    for (const auto& ship : layout.ships) {
+        out += ' ';
+        out += std::to_string(ship.x);
+        out += ',';
+        out += std::to_string(ship.y);
+        out += ',';
+        out += std::to_string(ship.length);
+        out += ship.horizontal ? 'h' : 'v';
+    }
+    out += " ;";
+    for (auto [x, y] : layout.mines) {
+        out += ' ';
+        out += std::to_string(x);
+        out += ',';
+        out += std::to_string(y);
+    }
+    out += '\n';
+}
+
+bool validateLayout(const Layout& layout, GameBoard& board, int& item, std::string& message) {
+    int size = layout.size;
+    if (board.getSize() != size) throw std::invalid_argument("Validation board has a different size");
+    item = -1;
+
+    // Состав флота: сколько кораблей каждой длины
+    thread_local std::vector<int> counts;
+    counts.assign(static_cast<size_t>(size) + 1, 0);
+    for (size_t i = 0; i < layout.ships.size(); ++i) {
+        int length = layout.ships[i].length;
+        if (length < 1 || length > size) {
+            item = static_cast<int>(i);
+            message = describeShip(layout.ships[i]) + ": length must be between 1 and " + std::to_string(size);
+            return false;
+        }
+        counts[length]++;
+    }
+    // Флот зависит только от размера, поэтому считается один раз на поток
+    thread_local std::vector<std::vector<ShipType>> fleets;
+    if (fleets.size() <= static_cast<size_t>(size)) fleets.resize(static_cast<size_t>(size) + 1);
+    auto& fleet = fleets[size];
+    if (fleet.empty()) fleet = calculateFleet(size);
+    for (const auto& type : fleet) {
+        if (counts[type.length] != type.count) {
+            message = "expected " + std::to_string(type.count) + " ships of length " + std::to_string(type.length) +
+                      ", found " + std::to_string(counts[type.length]);
+            return false;
+        }
+        counts[type.length] = 0;
+    }
+    for (size_t i = 0; i < layout.ships.size(); ++i) {
+        if (counts[layout.ships[i].length] != 0) {
+            item = static_cast<int>(i);
+            message = describeShip(layout.ships[i]) + ": no ships of this length in the fleet";
+            return false;
+        }
+    }
+    int mines = calculateMineCount(size);
+    if (static_cast<int>(layout.mines.size()) != mines) {
+        message = "expected " + std::to_string(mines) + " mines, found " + std::to_string(layout.mines.size());
+        return false;
+    }
+
+    // Размещение — теми же проверками, что при ручной расстановке
+    board.reset();
+    for (size_t i = 0; i < layout.ships.size(); ++i) {
+        const auto& ship = layout.ships[i];
+        if (!board.placeShip(ship.x, ship.y, ship.length, ship.horizontal)) {
+            item = static_cast<int>(i);
+            bool inside = board.isValidPosition(ship.x, ship.y) &&
+                          (ship.horizontal ? ship.x + ship.length <= size : ship.y + ship.length <= size);
+            message = describeShip(ship) + (inside ? " touches or overlaps another ship" : " goes off the board");
+            return false;
+        }
+    }
+    for (size_t i = 0; i < layout.mines.size(); ++i) {
+        auto [x, y] = layout.mines[i];
+        if (!board.placeMine(x, y)) {
+            item = static_cast<int>(layout.ships.size() + i);
+            if (!board.isValidPosition(x, y)) message = describeMine(x, y) + " is off the board";
+            else if (board.getBoard()[y][x] != 0) message = describeMine(x, y) + " is on an occupied cell";
+            else message = describeMine(x, y) + " is next to a ship";
+            return false;
+        }
+    }
+    return true;
+}
+
+LayoutLoader::LayoutLoader(ThreadPool* pool) : pool_(pool) {
+}
+
+LayoutLoadStats LayoutLoader::load(const std::string& path, GameRecordWriter* archive, std::ostream* errors) {
+    MappedFile file(path);
+    const char* data = reinterpret_cast<const char*>(file.data());
+    std::size_t length = file.size();
+
+    // Границы кусков — сразу после перевода строки
+    std::vector<std::size_t> starts = {0};
+    for (std::size_t pos = kChunkBytes; pos < length; pos += kChunkBytes) {
+        if (pos <= starts.back()) continue;
+        const void* newline = std::memchr(data + pos, '\n', length - pos);
+        if (!newline) break;
+        std::size_t start = static_cast<const char*>(newline) - data + 1;
+        if (start < length) starts.push_back(start);
+    }
+    starts.push_back(length);
+    int chunks = static_cast<int>(starts.size()) - 1;
+
+    // Номер первой строки каждого куска
+    std::vector<std::uint64_t> firstLine(static_cast<size_t>(chunks) + 1, 1);
+    auto countLines = [&](int c) {
+        std::uint64_t lines = 0;
+        const char* pos = data + starts[c];
+        const char* end = data + starts[c + 1];
+        while ((pos = static_cast<const char*>(std::memchr(pos, '\n', end - pos))) != nullptr) {
+            ++lines;
+            ++pos;
+        }
+        firstLine[c + 1] = lines;
+    };
+    if (pool_) pool_->parallelFor(chunks, countLines);
+    else for (int c = 0; c < chunks; ++c) countLines(c);
+    for (int c = 0; c < chunks; ++c) firstLine[c + 1] += firstLine[c];
+
+    std::vector<ChunkResult> results(static_cast<size_t>(chunks));
+    LayoutLoadStats total;
+    total.bytes = length;
+    std::mutex outputMutex;
+    int nextOutput = 0;
+
+    auto process = [&](int c) {
+        // Рабочие поля по размерам живут в потоке между кусками
+        thread_local std::vector<std::unique_ptr<GameBoard>> boards;
+        thread_local Layout layout;
+        thread_local std::vector<int> columns;
+
+        ChunkResult& result = results[c];
+        std::string message;
+        auto reportError = [&](std::uint64_t line, int column, const std::string& text) {
+            result.stats.invalid++;
+            if (!errors) return;
+            result.errors += std::to_string(line) + ":" + std::to_string(column) + ": " + text + "\n";
+        };
+
+        const char* pos = data + starts[c];
+        const char* end = data + starts[c + 1];
+        for (std::uint64_t line = firstLine[c]; pos < end; ++line) {
+            const char* newline = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+            const char* lineEnd = newline ? newline : end;
+            const char* next = newline ? newline + 1 : end;
+            if (lineEnd > pos && lineEnd[-1] == '\r') --lineEnd;
+            const char* first = pos;
+            skipSpaces(first, lineEnd);
+            if (first == lineEnd || *first == '#') {
+                pos = next;
+                continue;
+            }
+            result.stats.lines++;
+
+            int column = 0;
+            if (!parseLayoutLine(pos, lineEnd, layout, column, message, &columns)) {
+                reportError(line, column, message);
+            } else if (layout.size < 1 || layout.size > kMaxLayoutSize) {
+                reportError(line, static_cast<int>(first - pos) + 1,
+                            "board size must be between 1 and " + std::to_string(kMaxLayoutSize));
+            } else {
+                if (boards.size() <= static_cast<size_t>(layout.size)) boards.resize(layout.size + 1);
+                auto& board = boards[layout.size];
+                if (!board) board = std::make_unique<GameBoard>(layout.size);
+                int item;
+                if (!validateLayout(layout, *board, item, message)) {
+                    reportError(line, item >= 0 ? columns[item] : static_cast<int>(first - pos) + 1, message);
+                } else {
+                    result.stats.valid++;
+                    if (archive) {
+                        GameRecordWriter::encodeLayout(result.records, layout, line, calculateMineCount(layout.size));
+                    }
+                }
+            }
+            pos = next;
+        }
+
+        // Готовые куски выводятся строго по порядку тем потоком, который закрыл очередь
+        std::lock_guard<std::mutex> lock(outputMutex);
+        result.done = true;
+        while (nextOutput < chunks && results[nextOutput].done) {
+            ChunkResult& ready = results[nextOutput];
+            if (archive && !ready.records.empty()) archive->appendEncoded(ready.records);
+            if (errors) *errors << ready.errors;
+            total.lines += ready.stats.lines;
+            total.valid += ready.stats.valid;
+            total.invalid += ready.stats.invalid;
+            std::vector<unsigned char>().swap(ready.records);
+            std::string().swap(ready.errors);
+            nextOutput++;
+        }
+    };
+    if (pool_) pool_->parallelFor(chunks, process);
+    else for (int c = 0; c < chunks; ++c) process(c);
+    return total;
+}
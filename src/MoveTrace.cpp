@@ -0,0 +1,138 @@
+#include "../include/MoveTrace.h"
+#include "../include/GameBoard.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+// Под число кадров в заголовке резервируем место, чтобы перезаписать его на месте
+const int kCountDigits = 20;
+
+std::string npyHeaderDict(int n, const std::string& count) {
+    std::string shape = "(" + std::to_string(n) + ", " + std::to_string(n) + ")";
+    return "{'descr': [('game', '<u4'), ('move', '<u4'), ('x', '<i4'), ('y', '<i4'), "
+           "('ship', '<f8', " + shape + "), ('mine', '<f8', " + shape + "), ('observed', 'i1', " + shape + ")], "
+           "'fortran_order': False, 'shape': (" + count + ",), }";
+}
+
+} // namespace
+
+MoveTraceWriter::MoveTraceWriter(const std::string& path, int boardSize)
+    : file_(std::fopen(path.c_str(), "wb"))
+    , boardSize_(boardSize)
+    , frameBytes_(16 + static_cast<std::size_t>(boardSize) * boardSize * (8 + 8 + 1))
+    , headerBytes_(0)
+    , frameCount_(0)
+{
+    if (!file_) {
+        throw std::runtime_error("Cannot open trace file: " + path);
+    }
+    // Магия (6) + версия (2) + длина заголовка (2) + словарь + '\n', выровнено на 64 байта
+    std::size_t dictLength = npyHeaderDict(boardSize_, std::string(kCountDigits, '0')).size();
+    headerBytes_ = (10 + dictLength + 1 + 63) / 64 * 64;
+    writeHeader();
+}
+
+MoveTraceWriter::~MoveTraceWriter() {
+    close();
+}
+
+void MoveTraceWriter::writeHeader() {
+    std::string dict = npyHeaderDict(boardSize_, std::to_string(frameCount_));
+    dict.resize(headerBytes_ - 10 - 1, ' ');
+    dict += '\n';
+    unsigned short dictLength = static_cast<unsigned short>(dict.size());
+    const unsigned char prefix[10] = {
+        0x93, 'N', 'U', 'M', 'P', 'Y', 1, 0,
+        static_cast<unsigned char>(dictLength & 0xFF), static_cast<unsigned char>(dictLength >> 8)
+    };
+    std::fseek(file_, 0, SEEK_SET);
+    std::fwrite(prefix, 1, sizeof(prefix), file_);
+    std::fwrite(dict.data(), 1, dict.size(), file_);
+    std::fseek(file_, 0, SEEK_END);
+}
+
+void MoveTraceWriter::writeFrames(const unsigned char* data, std::size_t frames) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_) {
+        throw std::runtime_error("Trace file is closed");
+    }
+    if (std::fwrite(data, frameBytes_, frames, file_) != frames) {
+        throw std::runtime_error("Failed to write trace frames");
+    }
+    frameCount_ += frames;
+}
+
+void MoveTraceWriter::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_) return;
+    writeHeader();
+    std::fclose(file_);
+    file_ = nullptr;
+}
+
+int MoveTraceWriter::getBoardSize() const {
+    return boardSize_;
+}
+
+std::size_t MoveTraceWriter::getFrameBytes() const {
+    return frameBytes_;
+}
+
+std::uint64_t MoveTraceWriter::getFrameCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return frameCount_;
+}
+
+MoveTraceBuffer::MoveTraceBuffer(MoveTraceWriter& writer, std::size_t batchBytes)
+    : writer_(writer)
+    , frames_(0)
+    , batchFrames_(std::max<std::size_t>(1, batchBytes / writer.getFrameBytes()))
+{
+    buffer_.resize(batchFrames_ * writer_.getFrameBytes());
+}
+
+MoveTraceBuffer::~MoveTraceBuffer() {
+    flush();
+}
+
+void MoveTraceBuffer::addFrame(std::uint32_t game, std::uint32_t move, const GameBoard& board, int x, int y) {
+    int n = writer_.getBoardSize();
+    if (board.getSize() != n) {
+        throw std::invalid_argument("Board size does not match trace file");
+    }
+    unsigned char* out = buffer_.data() + frames_ * writer_.getFrameBytes();
+    std::int32_t coords[2] = {x, y};
+    std::memcpy(out, &game, 4);
+    std::memcpy(out + 4, &move, 4);
+    std::memcpy(out + 8, coords, 8);
+    out += 16;
+
+    std::size_t rowBytes = static_cast<std::size_t>(n) * sizeof(double);
+    for (const auto& row : board.getShipProbabilities()) {
+        std::memcpy(out, row.data(), rowBytes);
+        out += rowBytes;
+    }
+    for (const auto& row : board.getMineProbabilities()) {
+        std::memcpy(out, row.data(), rowBytes);
+        out += rowBytes;
+    }
+    // Только то, что видно игроку: непростреленные корабли и мины в кадр не попадают
+    const auto& state = board.getBoard();
+    const auto& shots = board.getShotsBoard();
+    for (int y = 0; y < n; ++y) {
+        for (int x = 0; x < n; ++x) {
+            bool visible = shots[y][x] != 0 || state[y][x] == 5;
+            *out++ = static_cast<unsigned char>(visible ? state[y][x] : 0);
+        }
+    }
+
+    if (++frames_ == batchFrames_) flush();
+}
+
+void MoveTraceBuffer::flush() {
+    if (frames_ == 0) return;
+    writer_.writeFrames(buffer_.data(), frames_);
+    frames_ = 0;
+}
@@ -0,0 +1,165 @@
+#include "../include/OpeningBook.h"
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+const char kMagic[4] = {'B', 'S', 'O', 'B'};
+const std::uint32_t kVersion = 2;
+const std::size_t kFleetOffset = 40;
+const std::size_t kSlotSize = 16;
+
+void putU32(std::vector<unsigned char>& out, std::uint32_t value) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<unsigned char>(value >> (8 * i)));
+}
+
+void putU64(std::vector<unsigned char>& out, std::uint64_t value) {
+    for (int i = 0; i < 8; ++i) out.push_back(static_cast<unsigned char>(value >> (8 * i)));
+}
+
+std::uint32_t getU32(const unsigned char* pos) {
+    std::uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) value |= static_cast<std::uint32_t>(pos[i]) << (8 * i);
+    return value;
+}
+
+std::uint64_t getU64(const unsigned char* pos) {
+    std::uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) value |= static_cast<std::uint64_t>(pos[i]) << (8 * i);
+    return value;
+}
+
+[[noreturn]] void corrupt(const std::string& path, const char* reason) {
+    throw std::runtime_error("Bad opening book " + path + ": " + reason);
+}
+
+} // namespace
+
+std::uint64_t OpeningBook::extendKey(std::uint64_t key, int cell, ShotOutcome outcome) {
+    // splitmix64 от предыдущего ключа и хода
+    std::uint64_t z = key + 0x9e3779b97f4a7c15ULL * (static_cast<std::uint64_t>(cell) * 4 +
+                                                     static_cast<std::uint64_t>(outcome) + 1);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    z ^= z >> 31;
+    return z != 0 ? z : 1;
+}
+
+void OpeningBook::write(const std::string& path, int size, int maxLives, const AlgorithmParams& params,
+                        int depth, const std::vector<OpeningBookEntry>& entries) {
+    std::vector<unsigned char> data(kMagic, kMagic + 4);
+    putU32(data, kVersion);
+    putU32(data, BattleshipAlgorithm::kEngineVersion);
+    putU64(data, hashParams(params));
+    putU32(data, static_cast<std::uint32_t>(size));
+    putU32(data, static_cast<std::uint32_t>(calculateMineCount(size)));
+    putU32(data, static_cast<std::uint32_t>(maxLives));
+    putU32(data, static_cast<std::uint32_t>(depth));
+    auto fleet = calculateFleet(size);
+    putU32(data, static_cast<std::uint32_t>(fleet.size()));
+    for (const auto& ship : fleet) {
+        putU32(data, static_cast<std::uint32_t>(ship.length));
+        putU32(data, static_cast<std::uint32_t>(ship.count));
+    }
+    while (data.size() % 8 != 0) data.push_back(0);
+
+    // Заполнение не больше половины, чтобы цепочки пробирования оставались короткими
+    std::uint64_t capacity = 16;
+    while (capacity < entries.size() * 2) capacity *= 2;
+    putU64(data, capacity);
+    putU64(data, entries.size());
+    std::size_t slots = data.size();
+    data.resize(slots + capacity * kSlotSize, 0);
+    for (const auto& entry : entries) {
+        std::uint64_t index = entry.key & (capacity - 1);
+        while (getU64(&data[slots + index * kSlotSize]) != 0) index = (index + 1) & (capacity - 1);
+        std::vector<unsigned char> slot;
+        putU64(slot, entry.key);
+        putU32(slot, static_cast<std::uint32_t>(entry.cell));
+        putU32(slot, static_cast<std::uint32_t>(entry.votes));
+        std::memcpy(&data[slots + index * kSlotSize], slot.data(), kSlotSize);
+    }
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) throw std::runtime_error("Cannot open " + path + " for writing");
+    bool ok = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) throw std::runtime_error("Failed to write " + path);
+}
+
+OpeningBook::OpeningBook(const std::string& path)
+    : file_(path), size_(0), maxLives_(0), paramsHash_(0), depth_(0), entryCount_(0), slots_(nullptr), mask_(0) {
+    const unsigned char* data = file_.data();
+    std::size_t length = file_.size();
+    if (length < 8 || std::memcmp(data, kMagic, 4) != 0) corrupt(path, "not an opening book");
+    if (getU32(data + 4) != kVersion) corrupt(path, "unsupported version, rebuild it with battleship_book");
+    if (length < kFleetOffset) corrupt(path, "truncated header");
+    // Ходы книги — ходы движка, который её строил
+    if (getU32(data + 8) != BattleshipAlgorithm::kEngineVersion) corrupt(path, "built by another engine version");
+    paramsHash_ = getU64(data + 12);
+    size_ = static_cast<int>(getU32(data + 20));
+    int mines = static_cast<int>(getU32(data + 24));
+    maxLives_ = static_cast<int>(getU32(data + 28));
+    depth_ = static_cast<int>(getU32(data + 32));
+    std::size_t fleetCount = getU32(data + 36);
+    std::size_t offset = kFleetOffset + fleetCount * 8;
+    if (size_ <= 0 || maxLives_ <= 0 || offset > length) corrupt(path, "truncated header");
+
+    // Книга годится только для тех правил, под которые её считали
+    auto fleet = calculateFleet(size_);
+    bool sameRules = fleet.size() == fleetCount && mines == calculateMineCount(size_);
+    for (std::size_t i = 0; sameRules && i < fleetCount; ++i) {
+        sameRules = fleet[i].length == static_cast<int>(getU32(data + kFleetOffset + i * 8)) &&
+                    fleet[i].count == static_cast<int>(getU32(data + kFleetOffset + 4 + i * 8));
+    }
+    if (!sameRules) corrupt(path, "built for different fleet or mine rules");
+
+    offset = (offset + 7) / 8 * 8;
+    if (offset + 16 > length) corrupt(path, "truncated header");
+    std::uint64_t capacity = getU64(data + offset);
+    std::uint64_t entries = getU64(data + offset + 8);
+    offset += 16;
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0 || entries >= capacity ||
+        (length - offset) / kSlotSize < capacity) {
+        corrupt(path, "bad slot table");
+    }
+    // Таблицу не читаем заранее: страницы подтянутся при первых обращениях
+    slots_ = data + offset;
+    mask_ = capacity - 1;
+    entryCount_ = static_cast<std::size_t>(entries);
+}
+
+int OpeningBook::size() const {
+    return size_;
+}
+
+int OpeningBook::maxLives() const {
+    return maxLives_;
+}
+
+std::uint64_t OpeningBook::paramsHash() const {
+    return paramsHash_;
+}
+
+int OpeningBook::depth() const {
+    return depth_;
+}
+
+std::size_t OpeningBook::entryCount() const {
+    return entryCount_;
+}
+
+int OpeningBook::lookup(std::uint64_t key) const {
+    std::uint64_t index = key & mask_;
+    for (std::uint64_t probe = 0; probe <= mask_; ++probe, index = (index + 1) & mask_) {
+        const unsigned char* slot = slots_ + index * kSlotSize;
+        std::uint64_t stored = getU64(slot);
+        if (stored == 0) return -1;
+        if (stored == key) {
+            std::uint32_t cell = getU32(slot + 8);
+            return cell < static_cast<std::uint32_t>(size_ * size_) ? static_cast<int>(cell) : -1;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,277 @@
+#include "../include/ResultAggregator.h"
+#include <algorithm>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+// Имена этапов для столбцов и ключей
+const char* const kStageColumns[kSearchStageCount] = {
+    "none", "fallback", "kill", "last_hit", "candidates", "pattern", "full_board", "endgame", "book"
+};
+
+// Единственный писатель: обычное чтение и запись, но атомарные, чтобы снимок не был гонкой
+void bump(std::atomic<std::uint64_t>& counter, std::uint64_t amount = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+std::uint64_t total(const std::vector<std::uint64_t>& counts) {
+    std::uint64_t sum = 0;
+    for (auto count : counts) sum += count;
+    return sum;
+}
+
+void addHistogram(std::vector<std::uint64_t>& into, const std::vector<std::uint64_t>& counts) {
+    if (into.size() < counts.size()) into.resize(counts.size(), 0);
+    for (size_t i = 0; i < counts.size(); ++i) into[i] += counts[i];
+}
+
+void writeInterval(std::ostream& out, const Interval& interval) {
+    out << interval.value << "," << interval.low << "," << interval.high;
+}
+
+void writeJsonInterval(std::ostream& out, const char* name, const Interval& interval) {
+    out << "\"" << name << "\": {\"value\": " << interval.value << ", \"low\": " << interval.low
+        << ", \"high\": " << interval.high << "}";
+}
+
+void writeJsonHistogram(std::ostream& out, const char* name, const std::vector<std::uint64_t>& counts) {
+    out << "      \"" << name << "\": {";
+    writeJsonInterval(out, "mean", histogramMean(counts));
+    out << ", \"p50\": " << histogramQuantile(counts, 0.5) << ", \"p90\": " << histogramQuantile(counts, 0.9)
+        << ", \"p99\": " << histogramQuantile(counts, 0.99) << ", \"histogram\": [";
+    // Хвост нулей не пишем
+    size_t used = counts.size();
+    while (used > 0 && counts[used - 1] == 0) used--;
+    for (size_t i = 0; i < used; ++i) out << (i > 0 ? ", " : "") << counts[i];
+    out << "]}";
+}
+
+} // namespace
+
+ShardHistogram::ShardHistogram(std::atomic<std::uint64_t>* bins, int count) : bins_(bins), count_(count) {}
+
+void ShardHistogram::add(int value) {
+    int index = std::min(std::max(value, 0), count_ - 1);
+    bump(bins_[index]);
+}
+
+void ShardHistogram::addTo(std::vector<std::uint64_t>& counts) const {
+    if (counts.size() < static_cast<size_t>(count_)) counts.resize(count_, 0);
+    for (int i = 0; i < count_; ++i) counts[i] += bins_[i].load(std::memory_order_relaxed);
+}
+
+Interval histogramMean(const std::vector<std::uint64_t>& counts) {
+    RunningStats stats;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        if (counts[i] > 0) stats.add(static_cast<double>(i), counts[i]);
+    }
+    return stats.meanInterval();
+}
+
+int histogramQuantile(const std::vector<std::uint64_t>& counts, double q) {
+    std::uint64_t sum = total(counts);
+    if (sum == 0) return -1;
+    double target = q * static_cast<double>(sum);
+    std::uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        seen += counts[i];
+        if (static_cast<double>(seen) >= target && seen > 0) return static_cast<int>(i);
+    }
+    return static_cast<int>(counts.size()) - 1;
+}
+
+namespace {
+
+// Строка кэша счётчиков: блок из таких строк начинается и кончается на границе строки
+struct alignas(64) CounterLine {
+    std::atomic<std::uint64_t> values[8];
+};
+
+// Счётчиков на размер: games, wins, этапы и три гистограммы
+size_t countersPerSize(int size) {
+    return 2 + 2 * kSearchStageCount + 2 * static_cast<size_t>(size * size + 1) +
+           static_cast<size_t>(calculateMineCount(size) + 1);
+}
+
+} // namespace
+
+// Счётчики одного размера внутри блока потока
+struct ResultAggregator::SizeShard {
+    SizeShard(int size, std::atomic<std::uint64_t>* block)
+        : games(block), wins(block + 1), stageShots(block + 2), stageHits(block + 2 + kSearchStageCount),
+          movesToWin(block + 2 + 2 * kSearchStageCount, size * size + 1),
+          livesLost(block + 2 + 2 * kSearchStageCount + size * size + 1, calculateMineCount(size) + 1),
+          killLength(block + 2 + 2 * kSearchStageCount + size * size + 1 + calculateMineCount(size) + 1,
+                     size * size + 1) {}
+
+    std::atomic<std::uint64_t>* games;
+    std::atomic<std::uint64_t>* wins;
+    std::atomic<std::uint64_t>* stageShots;
+    std::atomic<std::uint64_t>* stageHits;
+    ShardHistogram movesToWin;
+    ShardHistogram livesLost;
+    ShardHistogram killLength;
+};
+
+struct ResultAggregator::Shard {
+    // Все счётчики потока одним блоком целых строк кэша
+    std::unique_ptr<CounterLine[]> counters;
+    std::vector<SizeShard> sizes;
+    // Рабочие массивы record: корабль в клетке и число попаданий по кораблю
+    std::vector<int> shipAt;
+    std::vector<int> shipHits;
+};
+
+ResultAggregator::ResultAggregator(const std::vector<int>& sizes, int threads) : sizes_(sizes) {
+    if (threads < 1) throw std::invalid_argument("Aggregator needs at least one thread");
+    size_t perThread = 0;
+    for (int size : sizes_) {
+        if (size < 1) throw std::invalid_argument("Board size must be positive");
+        perThread += countersPerSize(size);
+    }
+    for (int t = 0; t < threads; ++t) {
+        auto shard = std::make_unique<Shard>();
+        size_t lines = std::max<size_t>(1, (perThread + 7) / 8);
+        shard->counters = std::make_unique<CounterLine[]>(lines);
+        std::atomic<std::uint64_t>* block = shard->counters[0].values;
+        for (size_t i = 0; i < lines * 8; ++i) block[i].store(0, std::memory_order_relaxed);
+        for (int size : sizes_) {
+            shard->sizes.emplace_back(size, block);
+            block += countersPerSize(size);
+        }
+        shards_.push_back(std::move(shard));
+    }
+}
+
+ResultAggregator::~ResultAggregator() = default;
+
+void ResultAggregator::record(int thread, const Layout& layout, const GameResult& result,
+                              const std::vector<MoveRecord>& moves) {
+    auto it = std::find(sizes_.begin(), sizes_.end(), layout.size);
+    if (it == sizes_.end()) {
+        throw std::invalid_argument("Board size " + std::to_string(layout.size) + " is not aggregated");
+    }
+    Shard& shard = *shards_.at(static_cast<size_t>(thread));
+    SizeShard& stats = shard.sizes[static_cast<size_t>(it - sizes_.begin())];
+    int size = layout.size;
+
+    bump(*stats.games);
+    if (result.victory) {
+        bump(*stats.wins);
+        stats.movesToWin.add(result.moves);
+    }
+    stats.livesLost.add(calculateMineCount(size) - result.livesLeft);
+
+    // Серия добивания повторяет жизнь woundedCells_: начинается попаданием в целый
+    // корабль, когда раненых нет, и заканчивается, когда все раненые потоплены
+    shard.shipAt.assign(static_cast<size_t>(size * size), -1);
+    shard.shipHits.assign(layout.ships.size(), 0);
+    for (size_t i = 0; i < layout.ships.size(); ++i) {
+        const auto& ship = layout.ships[i];
+        for (int d = 0; d < ship.length; ++d) {
+            int x = ship.horizontal ? ship.x + d : ship.x;
+            int y = ship.horizontal ? ship.y : ship.y + d;
+            if (x < size && y < size) shard.shipAt[y * size + x] = static_cast<int>(i);
+        }
+    }
+    int wounded = 0;
+    size_t seriesStart = 0;
+    for (size_t i = 0; i < moves.size(); ++i) {
+        const auto& move = moves[i];
+        bool hit = move.outcome == ShotOutcome::Hit || move.outcome == ShotOutcome::Sunk;
+        int stage = static_cast<int>(move.stage);
+        if (stage >= 0 && stage < kSearchStageCount) {
+            bump(stats.stageShots[stage]);
+            if (hit) bump(stats.stageHits[stage]);
+        }
+        int ship = shard.shipAt[move.y * size + move.x];
+        if (!hit || ship == -1) continue;
+        if (shard.shipHits[ship]++ == 0 && wounded++ == 0) seriesStart = i;
+        if (shard.shipHits[ship] == layout.ships[ship].length && --wounded == 0) {
+            stats.killLength.add(static_cast<int>(i - seriesStart + 1));
+        }
+    }
+}
+
+std::vector<SizeSummary> ResultAggregator::snapshot() const {
+    std::vector<SizeSummary> summary(sizes_.size() + 1);
+    SizeSummary& overall = summary.back();
+    for (size_t k = 0; k < sizes_.size(); ++k) {
+        SizeSummary& entry = summary[k];
+        entry.size = sizes_[k];
+        for (const auto& shard : shards_) {
+            const SizeShard& stats = shard->sizes[k];
+            entry.games += stats.games->load(std::memory_order_relaxed);
+            entry.wins += stats.wins->load(std::memory_order_relaxed);
+            stats.movesToWin.addTo(entry.movesToWin);
+            stats.livesLost.addTo(entry.livesLost);
+            stats.killLength.addTo(entry.killLength);
+            for (int s = 0; s < kSearchStageCount; ++s) {
+                entry.stageShots[s] += stats.stageShots[s].load(std::memory_order_relaxed);
+                entry.stageHits[s] += stats.stageHits[s].load(std::memory_order_relaxed);
+            }
+        }
+        overall.games += entry.games;
+        overall.wins += entry.wins;
+        addHistogram(overall.movesToWin, entry.movesToWin);
+        addHistogram(overall.livesLost, entry.livesLost);
+        addHistogram(overall.killLength, entry.killLength);
+        for (int s = 0; s < kSearchStageCount; ++s) {
+            overall.stageShots[s] += entry.stageShots[s];
+            overall.stageHits[s] += entry.stageHits[s];
+        }
+    }
+    return summary;
+}
+
+void writeSummaryCsv(std::ostream& out, const std::vector<SizeSummary>& summary) {
+    out << "size,games,wins,survival,survival_low,survival_high,"
+        << "moves_to_win,moves_to_win_low,moves_to_win_high,moves_to_win_p50,moves_to_win_p90,moves_to_win_p99,"
+        << "lives_lost,lives_lost_low,lives_lost_high,"
+        << "kills,kill_length,kill_length_low,kill_length_high,kill_length_p50,kill_length_p90";
+    for (const char* stage : kStageColumns) out << ",shots_" << stage << ",hits_" << stage;
+    out << "\n";
+    for (const auto& entry : summary) {
+        if (entry.size > 0) out << entry.size;
+        else out << "all";
+        out << "," << entry.games << "," << entry.wins << ",";
+        writeInterval(out, wilsonInterval(entry.wins, entry.games));
+        out << ",";
+        writeInterval(out, histogramMean(entry.movesToWin));
+        out << "," << histogramQuantile(entry.movesToWin, 0.5) << "," << histogramQuantile(entry.movesToWin, 0.9)
+            << "," << histogramQuantile(entry.movesToWin, 0.99) << ",";
+        writeInterval(out, histogramMean(entry.livesLost));
+        out << "," << total(entry.killLength) << ",";
+        writeInterval(out, histogramMean(entry.killLength));
+        out << "," << histogramQuantile(entry.killLength, 0.5) << "," << histogramQuantile(entry.killLength, 0.9);
+        for (int s = 0; s < kSearchStageCount; ++s) out << "," << entry.stageShots[s] << "," << entry.stageHits[s];
+        out << "\n";
+    }
+}
+
+void writeSummaryJson(std::ostream& out, const std::vector<SizeSummary>& summary) {
+    out << "{\n  \"sizes\": [\n";
+    for (size_t k = 0; k < summary.size(); ++k) {
+        const auto& entry = summary[k];
+        out << "    {\n      \"size\": ";
+        if (entry.size > 0) out << entry.size;
+        else out << "\"all\"";
+        out << ",\n      \"games\": " << entry.games << ",\n      \"wins\": " << entry.wins << ",\n      ";
+        writeJsonInterval(out, "survival", wilsonInterval(entry.wins, entry.games));
+        out << ",\n";
+        writeJsonHistogram(out, "moves_to_win", entry.movesToWin);
+        out << ",\n";
+        writeJsonHistogram(out, "lives_lost", entry.livesLost);
+        out << ",\n";
+        writeJsonHistogram(out, "kill_length", entry.killLength);
+        out << ",\n      \"stages\": {";
+        for (int s = 0; s < kSearchStageCount; ++s) {
+            out << (s > 0 ? ", " : "") << "\"" << kStageColumns[s] << "\": {\"shots\": " << entry.stageShots[s]
+                << ", \"hits\": " << entry.stageHits[s] << "}";
+        }
+        out << "}\n    }" << (k + 1 < summary.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
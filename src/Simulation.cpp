@@ -0,0 +1,84 @@
+#include "../include/Simulation.h"
+#include "../include/GameBoard.h"
+#include "../include/BattleshipAlgorithm.h"
+#include "../include/FixedBattleshipAlgorithm.h"
+#include <memory>
+
+ShotOutcome classifyShot(const GameBoard& board, int x, int y, bool hit) {
+    if (hit) {
+        for (const auto& ship : board.getShips()) {
+            for (auto [sx, sy] : ship.cells) {
+                if (sx == x && sy == y) {
+                    return ship.isSunk(board.getBoardInternal()) ? ShotOutcome::Sunk : ShotOutcome::Hit;
+                }
+            }
+        }
+        return ShotOutcome::Hit;
+    }
+    return board.getBoard()[y][x] == 4 ? ShotOutcome::Mine : ShotOutcome::Miss;
+}
+
+namespace {
+
+template <int N>
+GameResult playFixedGame(const Layout& layout, std::vector<MoveRecord>* moves, const AlgorithmParams& params) {
+    GameResult result;
+    FixedGameBoard<N> board;
+    for (const auto& ship : layout.ships) {
+        if (!board.placeShip(ship.x, ship.y, ship.length, ship.horizontal)) return result;
+    }
+    for (auto [x, y] : layout.mines) {
+        if (!board.placeMine(x, y)) return result;
+    }
+
+    FixedBattleshipAlgorithm<N> algorithm(board, calculateMineCount(N), params);
+    if (moves) moves->clear();
+    while (!board.isVictory() && algorithm.getCurrentLives() > 0) {
+        bool hit = algorithm.makeMove();
+        auto [x, y] = algorithm.getLastMove();
+        if (x == -1) break;  // Нет доступных ходов
+        result.moves++;
+        if (moves) {
+            ShotOutcome outcome = hit ? (board.isSunkAt(x, y) ? ShotOutcome::Sunk : ShotOutcome::Hit)
+                                      : (board.cell(x, y) == 4 ? ShotOutcome::Mine : ShotOutcome::Miss);
+            moves->push_back({x, y, outcome, algorithm.getLastStage()});
+        }
+    }
+    result.livesLeft = algorithm.getCurrentLives();
+    result.victory = board.isVictory();
+    return result;
+}
+
+} // namespace
+
+GameResult playGame(const Layout& layout, std::vector<MoveRecord>* moves, const AlgorithmParams& params) {
+    // Ходовые размеры играются на специализированном поле, остальные — на динамическом
+    switch (layout.size) {
+        case 10: return playFixedGame<10>(layout, moves, params);
+        case 12: return playFixedGame<12>(layout, moves, params);
+        case 15: return playFixedGame<15>(layout, moves, params);
+        case 20: return playFixedGame<20>(layout, moves, params);
+        default: return playDynamicGame(layout, moves, params);
+    }
+}
+
+GameResult playDynamicGame(const Layout& layout, std::vector<MoveRecord>* moves, const AlgorithmParams& params) {
+    GameResult result;
+    auto board = std::make_shared<GameBoard>(layout.size);
+    if (!applyLayout(*board, layout)) return result;
+
+    BattleshipAlgorithm algorithm(board, calculateMineCount(layout.size), params);
+    if (moves) moves->clear();
+    while (!board->isVictory() && algorithm.getCurrentLives() > 0) {
+        bool hit = algorithm.makeMove();
+        auto [x, y] = algorithm.getLastMove();
+        if (x == -1) break;  // Нет доступных ходов
+        result.moves++;
+        if (moves) {
+            moves->push_back({x, y, classifyShot(*board, x, y, hit), algorithm.getLastReport().stage});
+        }
+    }
+    result.livesLeft = algorithm.getCurrentLives();
+    result.victory = board->isVictory();
+    return result;
+}
@@ -0,0 +1,64 @@
+#include "../include/Statistics.h"
+#include <cmath>
+
+namespace {
+
+const double kZ95 = 1.959963984540054;
+
+} // namespace
+
+void RunningStats::add(double value) {
+    count_++;
+    double delta = value - mean_;
+    mean_ += delta / static_cast<double>(count_);
+    m2_ += delta * (value - mean_);
+}
+
+void RunningStats::add(double value, std::uint64_t times) {
+    RunningStats same;
+    same.count_ = times;
+    same.mean_ = value;
+    merge(same);
+}
+
+void RunningStats::merge(const RunningStats& other) {
+    if (other.count_ == 0) return;
+    if (count_ == 0) {
+        *this = other;
+        return;
+    }
+    // Параллельное объединение Чана
+    double total = static_cast<double>(count_ + other.count_);
+    double delta = other.mean_ - mean_;
+    mean_ += delta * static_cast<double>(other.count_) / total;
+    m2_ += other.m2_ + delta * delta * static_cast<double>(count_) * static_cast<double>(other.count_) / total;
+    count_ += other.count_;
+}
+
+std::uint64_t RunningStats::count() const {
+    return count_;
+}
+
+double RunningStats::mean() const {
+    return mean_;
+}
+
+double RunningStats::variance() const {
+    return count_ > 1 ? m2_ / static_cast<double>(count_ - 1) : 0.0;
+}
+
+Interval RunningStats::meanInterval() const {
+    double halfWidth = count_ > 1 ? kZ95 * std::sqrt(variance() / static_cast<double>(count_)) : 0.0;
+    return {mean_, mean_ - halfWidth, mean_ + halfWidth};
+}
+
+Interval wilsonInterval(std::uint64_t successes, std::uint64_t trials) {
+    if (trials == 0) return {0.0, 0.0, 1.0};
+    double n = static_cast<double>(trials);
+    double p = static_cast<double>(successes) / n;
+    double z2 = kZ95 * kZ95;
+    double denominator = 1.0 + z2 / n;
+    double center = (p + z2 / (2.0 * n)) / denominator;
+    double halfWidth = kZ95 * std::sqrt(p * (1.0 - p) / n + z2 / (4.0 * n * n)) / denominator;
+    return {p, center - halfWidth, center + halfWidth};
+}
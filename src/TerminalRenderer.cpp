@@ -0,0 +1,226 @@
+#include "../include/TerminalRenderer.h"
+#include "../include/GameBoard.h"
+#include <algorithm>
+#include <cstdlib>
+#include <ostream>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Размер терминала; если вывод не в терминал — COLUMNS/LINES или 80x24
+void terminalSize(int& columns, int& rows) {
+    columns = 0;
+    rows = 0;
+#ifdef _WIN32
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info)) {
+        columns = info.srWindow.Right - info.srWindow.Left + 1;
+        rows = info.srWindow.Bottom - info.srWindow.Top + 1;
+    }
+#else
+    winsize size{};
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0) {
+        columns = size.ws_col;
+        rows = size.ws_row;
+    }
+#endif
+    if (columns <= 0) {
+        const char* env = std::getenv("COLUMNS");
+        columns = env ? std::atoi(env) : 0;
+        if (columns <= 0) columns = 80;
+    }
+    if (rows <= 0) {
+        const char* env = std::getenv("LINES");
+        rows = env ? std::atoi(env) : 0;
+        if (rows <= 0) rows = 24;
+    }
+}
+
+int digits(int value) {
+    int count = 1;
+    while (value >= 10) {
+        value /= 10;
+        count++;
+    }
+    return count;
+}
+
+char cellGlyph(int cell, bool showShips) {
+    switch (cell) {
+        case 1: return showShips ? 'X' : ' ';  // Корабль
+        case 2: return showShips ? '*' : ' ';  // Мина
+        case 3: return 'X';                    // Пораженный корабль
+        case 4: return '!';                    // Сработавшая мина
+        case 5: return 'o';                    // Промах
+        default: return ' ';
+    }
+}
+
+} // namespace
+
+TerminalRenderer::TerminalRenderer(std::ostream& out, double framesPerSecond)
+    : out_(out), nextFrame_(std::chrono::steady_clock::now()), fastForward_(false),
+      viewX_(0), viewY_(0), viewColumns_(0), viewRows_(0), boardSize_(0), terminalColumns_(80) {
+    setFramesPerSecond(framesPerSecond);
+#ifdef _WIN32
+    // Консоль Windows понимает ANSI-последовательности только в этом режиме
+    HANDLE handle = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD mode = 0;
+    if (GetConsoleMode(handle, &mode)) SetConsoleMode(handle, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+#endif
+}
+
+void TerminalRenderer::setFramesPerSecond(double framesPerSecond) {
+    frameInterval_ = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(framesPerSecond > 0.0 ? 1.0 / framesPerSecond : 0.0));
+}
+
+void TerminalRenderer::setFastForward(bool enabled) {
+    fastForward_ = enabled;
+}
+
+bool TerminalRenderer::isFastForward() const {
+    return fastForward_;
+}
+
+void TerminalRenderer::scroll(int dx, int dy) {
+    viewX_ += dx;
+    viewY_ += dy;
+}
+
+void TerminalRenderer::follow(int x, int y) {
+    if (x < viewX_) viewX_ = x;
+    if (viewColumns_ > 0 && x >= viewX_ + viewColumns_) viewX_ = x - viewColumns_ + 1;
+    if (y < viewY_) viewY_ = y;
+    if (viewRows_ > 0 && y >= viewY_ + viewRows_) viewY_ = y - viewRows_ + 1;
+}
+
+bool TerminalRenderer::isViewportFull() const {
+    return viewColumns_ >= boardSize_ && viewRows_ >= boardSize_;
+}
+
+void TerminalRenderer::clear() {
+    shown_.clear();
+}
+
+void TerminalRenderer::updateViewport(int boardSize, int statusLines) {
+    int columns, rows;
+    terminalSize(columns, rows);
+    boardSize_ = boardSize;
+    terminalColumns_ = columns;
+    int labelWidth = digits(boardSize - 1) + 1;
+    int headerRows = boardSize > 10 ? 2 : 1;
+    // Под полем: пустая строка, статус, строка окна просмотра и строка для ввода
+    viewColumns_ = std::max(1, std::min(boardSize, (columns - labelWidth) / 2));
+    viewRows_ = std::max(1, std::min(boardSize, rows - headerRows - statusLines - 3));
+    viewX_ = std::max(0, std::min(viewX_, boardSize - viewColumns_));
+    viewY_ = std::max(0, std::min(viewY_, boardSize - viewRows_));
+}
+
+void TerminalRenderer::compose(const GameBoard& board, bool showShips, const std::vector<std::string>& status) {
+    int size = board.getSize();
+    const auto& cells = board.getBoard();
+    int labelWidth = digits(size - 1) + 1;
+    frame_.clear();
+
+    // Номера столбцов: десятки отдельной строкой, если поле шире 10
+    if (size > 10) {
+        std::string tens(labelWidth, ' ');
+        for (int x = viewX_; x < viewX_ + viewColumns_; ++x) {
+            tens += (x % 10 == 0 || x == viewX_) && x >= 10 ? static_cast<char>('0' + x / 10 % 10) : ' ';
+            tens += ' ';
+        }
+        frame_.push_back(tens);
+    }
+    std::string units(labelWidth, ' ');
+    for (int x = viewX_; x < viewX_ + viewColumns_; ++x) {
+        units += static_cast<char>('0' + x % 10);
+        units += ' ';
+    }
+    frame_.push_back(units);
+
+    for (int y = viewY_; y < viewY_ + viewRows_; ++y) {
+        std::string line = std::to_string(y);
+        line.insert(0, labelWidth - 1 - line.size(), ' ');
+        line += ' ';
+        for (int x = viewX_; x < viewX_ + viewColumns_; ++x) {
+            line += cellGlyph(cells[y][x], showShips);
+            line += ' ';
+        }
+        frame_.push_back(line);
+    }
+
+    frame_.emplace_back();
+    frame_.insert(frame_.end(), status.begin(), status.end());
+    if (!isViewportFull()) {
+        frame_.push_back("View: columns " + std::to_string(viewX_) + "-" + std::to_string(viewX_ + viewColumns_ - 1) +
+                         ", rows " + std::to_string(viewY_) + "-" + std::to_string(viewY_ + viewRows_ - 1) +
+                         " of " + std::to_string(size));
+    }
+    // Строки не длиннее терминала: перенос сдвинул бы весь кадр
+    for (auto& line : frame_) {
+        if (static_cast<int>(line.size()) >= terminalColumns_) line.resize(std::max(0, terminalColumns_ - 1));
+    }
+}
+
+void TerminalRenderer::emitDiff() {
+    buffer_.clear();
+    if (shown_.empty()) buffer_ += "\x1b[H\x1b[2J";  // Экран неизвестен — стираем и рисуем всё
+
+    // Соседние изменения, разделённые короткими совпадающими участками, выводятся
+    // одним куском: перевод курсора дороже нескольких лишних символов
+    const size_t kMaxGap = 4;
+    size_t lines = std::max(frame_.size(), shown_.size());
+    for (size_t i = 0; i < lines; ++i) {
+        std::string current = i < frame_.size() ? frame_[i] : std::string();
+        std::string previous = i < shown_.size() ? shown_[i] : std::string();
+        size_t width = std::max(current.size(), previous.size());
+        current.resize(width, ' ');
+        previous.resize(width, ' ');
+        size_t j = 0;
+        while (j < width) {
+            if (current[j] == previous[j]) {
+                j++;
+                continue;
+            }
+            size_t start = j;
+            size_t end = j;
+            for (size_t k = j; k < width && k - end <= kMaxGap; ++k) {
+                if (current[k] != previous[k]) end = k;
+            }
+            buffer_ += "\x1b[" + std::to_string(i + 1) + ";" + std::to_string(start + 1) + "H";
+            buffer_.append(current, start, end - start + 1);
+            j = end + 1;
+        }
+    }
+    // Курсор — под кадр, остаток экрана (прошлые подсказки и ввод) стираем
+    buffer_ += "\x1b[" + std::to_string(frame_.size() + 1) + ";1H\x1b[J";
+    out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    out_.flush();
+    shown_.swap(frame_);
+}
+
+bool TerminalRenderer::draw(const GameBoard& board, bool showShips, const std::vector<std::string>& status,
+                            bool force) {
+    auto now = std::chrono::steady_clock::now();
+    if (!force && now < nextFrame_) {
+        if (fastForward_) return false;
+        std::this_thread::sleep_until(nextFrame_);
+        now = nextFrame_;
+    }
+    nextFrame_ = now + frameInterval_;
+
+    int statusLines = static_cast<int>(status.size());
+    updateViewport(board.getSize(), statusLines);
+    compose(board, showShips, status);
+    emitDiff();
+    return true;
+}
@@ -0,0 +1,84 @@
+#include "../include/ThreadPool.h"
+#include <algorithm>
+#include <exception>
+
+ThreadPool::ThreadPool(int threads)
+    : stopping_(false)
+{
+    if (threads <= 0) {
+        threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    }
+    for (int i = 0; i < threads; ++i) {
+        workers_.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    taskReady_.notify_all();
+    for (auto& worker : workers_) worker.join();
+}
+
+int ThreadPool::size() const {
+    return static_cast<int>(workers_.size());
+}
+
+void ThreadPool::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        taskReady_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+        if (tasks_.empty()) return;  // stopping_ и работы не осталось
+        auto task = std::move(tasks_.front());
+        tasks_.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
+
+void ThreadPool::parallelFor(int count, const std::function<void(int)>& fn) {
+    if (count <= 0) return;
+    int remaining = count - 1;
+    std::exception_ptr error;
+    auto run = [&](int i) {
+        try {
+            fn(i);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error) error = std::current_exception();
+        }
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int i = 1; i < count; ++i) {
+            tasks_.emplace_back([&, i]() {
+                run(i);
+                std::lock_guard<std::mutex> doneLock(mutex_);
+                remaining--;
+                taskDone_.notify_all();
+            });
+        }
+    }
+    taskReady_.notify_all();
+
+    run(0);
+
+    // Пока ждём свои задачи, помогаем разбирать очередь
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (remaining > 0) {
+        if (!tasks_.empty()) {
+            auto task = std::move(tasks_.front());
+            tasks_.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+        } else {
+            taskDone_.wait(lock);
+        }
+    }
+    if (error) std::rethrow_exception(error);
+}
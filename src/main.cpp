@@ -1,11 +1,11 @@
 #include "../include/GameBoard.h"
 #include "../include/BattleshipAlgorithm.h"
+#include "../include/GameSetup.h"
+#include "../include/TerminalRenderer.h"
+#include <cctype>
 #include <iostream>
 #include <memory>
 #include <cmath>
-#include <windows.h>
-#include <fcntl.h>
-#include <io.h>
 #include <clocale>
 #include <limits>
 #include <string>
@@ -13,50 +13,16 @@
 #include <map>
 #include <vector>
 
-void clearScreen() {
-    system("cls");
-}
-
-void printBoard(const GameBoard& board, bool showShips = false) {
-    const auto& gameBoard = board.getBoard();
-    std::cout << "\n  ";
-    for (int i = 0; i < board.getSize(); ++i) {
-        std::cout << i << " ";
-    }
-    std::cout << "\n";
-    
-    for (int i = 0; i < board.getSize(); ++i) {
-        std::cout << i << " ";
-        for (int j = 0; j < board.getSize(); ++j) {
-            if (!showShips && (gameBoard[i][j] == 1 || gameBoard[i][j] == 2)) {
-                std::cout << "  "; // Скрываем корабли и мины
-            } else if (gameBoard[i][j] == 0) {
-                std::cout << "  "; // Пустая клетка всегда — пробел
-            } else {
-                switch (gameBoard[i][j]) {
-                    case 1: std::cout << "X "; break; // Корабль
-                    case 2: std::cout << "* "; break; // Мина
-                    case 3: std::cout << "X "; break; // Пораженный корабль
-                    case 4: std::cout << "! "; break; // Сработавшая мина
-                    case 5: std::cout << "o "; break; // Промах
-                    default: std::cout << "? "; break;
-                }
-            }
-        }
-        std::cout << "\n";
-    }
-    std::cout << "\n";
-}
-
-int calculateShipCount(int size) {
-    // По формуле из ReadMe: K = ⌊(20/100) * N²⌋
-    return static_cast<int>(std::floor(0.2 * size * size));
-}
+// Режимы просмотра партии
+enum class PlaybackMode {
+    Step = 1,        // ход по Enter
+    Auto = 2,        // ходы сами, с ограничением частоты кадров
+    FastForward = 3  // без пауз, лишние кадры пропускаются
+};
 
-int calculateMineCount(int size) {
-    // По формуле из ReadMe: M = ⌊0.03 * N²⌋
-    return static_cast<int>(std::floor(0.03 * size * size));
-}
+const double kAutoFramesPerSecond = 10.0;
+const double kFastForwardFramesPerSecond = 30.0;
+const int kScrollStep = 5;
 
 bool getValidInput(int& value, const std::string& prompt, int min, int max) {
     while (true) {
@@ -74,38 +40,7 @@ bool getValidInput(int& value, const std::string& prompt, int min, int max) {
     }
 }
 
-struct ShipType {
-    int length;
-    int count;
-};
-
-std::vector<ShipType> calculateFleet(int size) {
-    int area = size * size;
-    int totalDecks = static_cast<int>(area * 0.2 + 0.5); // 20% of area, rounded
-    std::vector<ShipType> baseFleet = {
-        {4, 1}, {3, 2}, {2, 3}
-    };
-    int usedDecks = 0;
-    std::vector<ShipType> fleet;
-    int scale = size / 10;
-    if (scale < 1) scale = 1;
-    // Масштабируем флот
-    for (auto ship : baseFleet) {
-        int newCount = ship.count * scale;
-        int newLength = ship.length * scale;
-        if (newLength > size) newLength = size;
-        fleet.push_back({newLength, newCount});
-        usedDecks += newCount * newLength;
-    }
-    // Остаток — однопалубные
-    int singleShips = totalDecks - usedDecks;
-    if (singleShips > 0) {
-        fleet.push_back({1, singleShips});
-    }
-    return fleet;
-}
-
-bool placeShips(GameBoard& board) {
+bool placeShips(GameBoard& board, TerminalRenderer& renderer) {
     int size = board.getSize();
     auto fleet = calculateFleet(size);
     std::map<int, int> placed; // length -> count
@@ -118,13 +53,16 @@ bool placeShips(GameBoard& board) {
     
     for (const auto& ship : fleet) {
         for (int i = 0; i < ship.count; ++i) {
-            clearScreen();
-            std::cout << "\nCurrent field:\n";
-            printBoard(board, true);
+            std::vector<std::string> status;
             for (const auto& s : fleet) {
-                std::cout << "Ships of length " << s.length << ": " << placed[s.length] << " of " << s.count << " placed\n";
+                status.push_back("Ships of length " + std::to_string(s.length) + ": " + std::to_string(placed[s.length]) +
+                                 " of " + std::to_string(s.count) + " placed");
             }
-            std::cout << "\nPlacing ship of length " << ship.length << " (" << (i+1) << " of " << ship.count << ")\n";
+            status.push_back("");
+            status.push_back("Placing ship of length " + std::to_string(ship.length) + " (" + std::to_string(i + 1) +
+                             " of " + std::to_string(ship.count) + ")");
+            renderer.clear();
+            renderer.draw(board, true, status, true);
             int x, y;
             char direction = 'h';
             if (!getValidInput(x, "Enter X coordinate (0-" + std::to_string(size-1) + "): ", 0, size-1)) continue;
@@ -161,7 +99,7 @@ bool placeShips(GameBoard& board) {
     return true;
 }
 
-bool placeMines(GameBoard& board) {
+bool placeMines(GameBoard& board, TerminalRenderer& renderer) {
     int size = board.getSize();
     int totalMines = calculateMineCount(size);
     int minesPlaced = 0;
@@ -170,10 +108,9 @@ bool placeMines(GameBoard& board) {
     std::cout << "Total mines to place: " << totalMines << "\n";
     
     while (minesPlaced < totalMines) {
-        clearScreen();
-        std::cout << "\nCurrent field:\n";
-        printBoard(board, true);
-        std::cout << "\nMines placed: " << minesPlaced << " of " << totalMines << "\n";
+        renderer.clear();
+        renderer.draw(board, true, {"Mines placed: " + std::to_string(minesPlaced) + " of " + std::to_string(totalMines)},
+                      true);
         
         int x, y;
         if (!getValidInput(x, "Enter X coordinate (0-" + std::to_string(size-1) + "): ", 0, size-1)) continue;
@@ -205,13 +142,14 @@ int main() {
         
         // Инициализация игры
         auto board = std::make_shared<GameBoard>(size);
+        TerminalRenderer renderer(std::cout);
         
         // Размещение кораблей и мин
-        if (!placeShips(*board)) {
+        if (!placeShips(*board, renderer)) {
             throw std::runtime_error("Error placing ships");
         }
         
-        if (!placeMines(*board)) {
+        if (!placeMines(*board, renderer)) {
             throw std::runtime_error("Error placing mines");
         }
         
@@ -219,43 +157,66 @@ int main() {
         int maxLives = calculateMineCount(size);
         BattleshipAlgorithm algorithm(board, maxLives);
         
+        int modeValue;
+        getValidInput(modeValue, "Playback mode (1 - step by step, 2 - auto, 3 - fast-forward): ", 1, 3);
+        std::cin.ignore(1000000, '\n');
+        PlaybackMode mode = static_cast<PlaybackMode>(modeValue);
+        renderer.setFramesPerSecond(mode == PlaybackMode::Auto ? kAutoFramesPerSecond : kFastForwardFramesPerSecond);
+        renderer.setFastForward(mode == PlaybackMode::FastForward);
+        
         // Игровой цикл
         int moves = 0;
         bool gameOver = false;
-        
-        clearScreen();
-        std::cout << "\nStart game!\n";
-        std::cout << "Board size: " << size << "x" << size << "\n";
-        std::cout << "Lives: " << maxLives << "\n\n";
+        renderer.clear();
         
         while (!gameOver) {
             moves++;
-            std::cout << "\nMove " << moves << ":\n";
-            
             bool hit = algorithm.makeMove();
-            if (hit) {
-                std::cout << "Hit!\n";
-            } else {
-                std::cout << "Miss!\n";
-            }
-            
-            std::cout << "Lives left: " << algorithm.getCurrentLives() << "\n";
-            std::cout << "Remaining ships: " << board->getRemainingShips() << "\n";
-            
-            printBoard(*board);
+            auto [x, y] = algorithm.getLastMove();
+            if (x != -1) renderer.follow(x, y);
             
+            std::vector<std::string> status = {
+                "Board size: " + std::to_string(size) + "x" + std::to_string(size) + ", lives: " + std::to_string(maxLives),
+                "Move " + std::to_string(moves) + ": (" + std::to_string(x) + ", " + std::to_string(y) + ") " +
+                    (hit ? "Hit!" : "Miss!"),
+                "Lives left: " + std::to_string(algorithm.getCurrentLives()),
+                "Remaining ships: " + std::to_string(board->getRemainingShips())
+            };
             if (board->isVictory()) {
-                std::cout << "\nVictory! All ships destroyed!\n";
+                status.push_back("Victory! All ships destroyed!");
                 gameOver = true;
             } else if (algorithm.getCurrentLives() <= 0) {
-                std::cout << "\nGame over! No more lives!\n";
+                status.push_back("Game over! No more lives!");
+                gameOver = true;
+            } else if (x == -1) {
+                status.push_back("No moves left!");
                 gameOver = true;
             }
             
-            std::cout << "Press Enter for next move...";
-            std::cin.ignore(1000000, '\n');
-            std::cin.get();
-            clearScreen();
+            if (mode != PlaybackMode::Step || gameOver) {
+                // Последний кадр рисуется всегда, даже в ускоренном режиме
+                renderer.draw(*board, false, status, gameOver);
+                continue;
+            }
+            
+            // Пошаговый режим: Enter — следующий ход, w/a/s/d — прокрутка, f — досмотреть без пауз
+            status.push_back("Enter - next move" + std::string(renderer.isViewportFull() ? "" : ", w/a/s/d - scroll") +
+                             ", f - fast-forward");
+            renderer.draw(*board, false, status, true);
+            std::string command;
+            while (std::getline(std::cin, command) && !command.empty()) {
+                char key = static_cast<char>(std::tolower(command[0]));
+                if (key == 'f') {
+                    mode = PlaybackMode::FastForward;
+                    renderer.setFastForward(true);
+                    break;
+                }
+                if (key == 'w') renderer.scroll(0, -kScrollStep);
+                if (key == 's') renderer.scroll(0, kScrollStep);
+                if (key == 'a') renderer.scroll(-kScrollStep, 0);
+                if (key == 'd') renderer.scroll(kScrollStep, 0);
+                renderer.draw(*board, false, status, true);
+            }
         }
         
         std::cout << "\nGame results:\n";
@@ -269,7 +230,6 @@ int main() {
     }
     
     std::cout << "\nPress Enter to exit...";
-    std::cin.ignore(1000000, '\n');
     std::cin.get();
     return 0;
-} 
\ No newline at end of file
+}
@@ -0,0 +1,228 @@
+# Проверка C ABI libbattleship через ctypes.
+#
+#   cmake -S . -B build && cmake --build build && python -m pytest tests
+#
+# Библиотека берётся из BATTLESHIP_LIB (так её передаёт ctest), иначе ищется в build/.
+
+import ctypes
+import os
+from pathlib import Path
+
+import numpy as np
+import pytest
+
+BS_OK = 0
+BS_GAME_OVER = 1
+BS_ERROR_ARGUMENT = -1
+BS_ERROR_LAYOUT = -2
+BS_ERROR_BUFFER = -3
+BS_ERROR_INTERNAL = -4
+
+BS_MISS, BS_HIT, BS_MINE, BS_SUNK = 0, 1, 2, 3
+
+
+class Ship(ctypes.Structure):
+    _fields_ = [("x", ctypes.c_int32), ("y", ctypes.c_int32),
+                ("length", ctypes.c_int32), ("horizontal", ctypes.c_int32)]
+
+
+class Cell(ctypes.Structure):
+    _fields_ = [("x", ctypes.c_int32), ("y", ctypes.c_int32)]
+
+
+class Move(ctypes.Structure):
+    _fields_ = [("x", ctypes.c_int32), ("y", ctypes.c_int32), ("outcome", ctypes.c_int32)]
+
+
+class GameResult(ctypes.Structure):
+    _fields_ = [("seed", ctypes.c_uint64), ("moves", ctypes.c_int32), ("lives_left", ctypes.c_int32),
+                ("victory", ctypes.c_int32), ("status", ctypes.c_int32)]
+
+
+def find_library():
+    path = os.environ.get("BATTLESHIP_LIB")
+    if path:
+        return path
+    root = Path(__file__).resolve().parent.parent
+    names = ["libbattleship.so", "libbattleship.dylib", "battleship.dll"]
+    for build in ["build", "x64/Release", "x64/Debug"]:
+        for name in names:
+            candidate = root / build / name
+            if candidate.exists():
+                return str(candidate)
+    pytest.skip("libbattleship not found; set BATTLESHIP_LIB")
+
+
+@pytest.fixture(scope="module")
+def lib():
+    lib = ctypes.CDLL(find_library())
+    lib.bs_abi_version.restype = ctypes.c_int32
+    lib.bs_game_create.restype = ctypes.c_void_p
+    lib.bs_game_create.argtypes = [ctypes.c_int32, ctypes.c_int32]
+    lib.bs_game_destroy.argtypes = [ctypes.c_void_p]
+    lib.bs_game_load_layout.restype = ctypes.c_int32
+    lib.bs_game_load_layout.argtypes = [ctypes.c_void_p, ctypes.POINTER(Ship), ctypes.c_size_t,
+                                        ctypes.POINTER(Cell), ctypes.c_size_t]
+    lib.bs_game_step.restype = ctypes.c_int32
+    lib.bs_game_step.argtypes = [ctypes.c_void_p, ctypes.POINTER(Move)]
+    for name in ["bs_game_size", "bs_game_lives", "bs_game_remaining_ships", "bs_game_is_over"]:
+        getattr(lib, name).restype = ctypes.c_int32
+        getattr(lib, name).argtypes = [ctypes.c_void_p]
+    for name in ["bs_game_read_ship_probabilities", "bs_game_read_mine_probabilities"]:
+        getattr(lib, name).restype = ctypes.c_int32
+        getattr(lib, name).argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_double), ctypes.c_size_t]
+    lib.bs_game_read_cells.restype = ctypes.c_int32
+    lib.bs_game_read_cells.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_int8), ctypes.c_size_t]
+    lib.bs_run_games.restype = ctypes.c_int32
+    lib.bs_run_games.argtypes = [ctypes.c_int32, ctypes.POINTER(ctypes.c_uint64), ctypes.c_size_t,
+                                 ctypes.c_int32, ctypes.POINTER(GameResult)]
+    assert lib.bs_abi_version() == 1
+    return lib
+
+
+@pytest.fixture
+def game(lib):
+    handle = lib.bs_game_create(10, 3)
+    assert handle
+    yield handle
+    lib.bs_game_destroy(handle)
+
+
+SHIPS = [(0, 0, 4, 1), (0, 2, 3, 1), (9, 0, 2, 0), (5, 5, 1, 1)]
+MINES = [(9, 9), (3, 7)]
+
+
+def load(lib, game, ships, mines):
+    ship_array = (Ship * max(1, len(ships)))(*[Ship(*s) for s in ships])
+    mine_array = (Cell * max(1, len(mines)))(*[Cell(*m) for m in mines])
+    return lib.bs_game_load_layout(game, ship_array, len(ships), mine_array, len(mines))
+
+
+def read_cells(lib, game):
+    cells = np.zeros((10, 10), dtype=np.int8)
+    status = lib.bs_game_read_cells(game, cells.ctypes.data_as(ctypes.POINTER(ctypes.c_int8)), cells.size)
+    assert status == BS_OK
+    return cells
+
+
+def test_load_layout_places_ships_and_mines(lib, game):
+    assert load(lib, game, SHIPS, MINES) == BS_OK
+    decks = sum(length for _, _, length, _ in SHIPS)
+    assert lib.bs_game_remaining_ships(game) == decks
+    assert lib.bs_game_lives(game) == 3
+    assert lib.bs_game_is_over(game) == 0
+    cells = read_cells(lib, game)
+    assert (cells == 1).sum() == decks
+    assert (cells == 2).sum() == len(MINES)
+    assert cells[0, 0:4].tolist() == [1, 1, 1, 1]
+    assert cells[9, 9] == 2
+
+
+@pytest.mark.parametrize("ships, mines", [
+    ([(0, 0, 0, 1)], []),                   # нулевая длина
+    ([(0, 0, -3, 1)], []),                  # отрицательная длина
+    ([(0, 0, 11, 1)], []),                  # длиннее поля
+    ([(0, 0, 2**31 - 1, 1)], []),           # переполнение x + length
+    ([(-1, 0, 2, 1)], []),                  # вне поля
+    ([(0, 10, 1, 1)], []),
+    ([(0, 0, 2, 2)], []),                   # horizontal не 0/1
+    ([(7, 0, 4, 1)], []),                   # не помещается
+    ([(0, 0, 3, 1), (0, 1, 2, 1)], []),     # касается другого корабля
+    ([(0, 0, 3, 1)], [(3, 1)]),             # мина рядом с кораблём
+    ([(0, 0, 3, 1)], [(10, 10)]),           # мина вне поля
+    ([(0, 0, 3, 1)], [(5, 5), (5, 5)]),     # две мины в одной клетке
+])
+def test_load_layout_rejects_invalid(lib, game, ships, mines):
+    assert load(lib, game, ships, mines) == BS_ERROR_LAYOUT
+    # Поле сброшено, партия не начата
+    assert lib.bs_game_remaining_ships(game) == 0
+    assert (read_cells(lib, game) == 0).all()
+    assert lib.bs_game_step(game, ctypes.byref(Move())) == BS_ERROR_LAYOUT
+    # После отказа правильная расстановка принимается
+    assert load(lib, game, SHIPS, MINES) == BS_OK
+    assert lib.bs_game_remaining_ships(game) == sum(length for _, _, length, _ in SHIPS)
+
+
+def test_null_arguments(lib, game):
+    assert lib.bs_game_load_layout(None, None, 0, None, 0) == BS_ERROR_ARGUMENT
+    assert lib.bs_game_load_layout(game, None, 1, None, 0) == BS_ERROR_ARGUMENT
+    assert lib.bs_game_step(game, None) == BS_ERROR_ARGUMENT
+    assert lib.bs_game_create(0, 3) is None
+    # Без жизней коэффициент риска делился бы на ноль
+    assert lib.bs_game_create(10, 0) is None
+    assert lib.bs_game_create(10, -1) is None
+
+
+def test_step_until_game_over(lib, game):
+    assert load(lib, game, SHIPS, MINES) == BS_OK
+    move = Move()
+    shots = set()
+    outcomes = []
+    for _ in range(100):
+        status = lib.bs_game_step(game, ctypes.byref(move))
+        if status == BS_GAME_OVER:
+            break
+        assert status == BS_OK
+        assert 0 <= move.x < 10 and 0 <= move.y < 10
+        assert (move.x, move.y) not in shots
+        shots.add((move.x, move.y))
+        outcomes.append(move.outcome)
+    else:
+        pytest.fail("game did not finish in 100 moves")
+    assert lib.bs_game_is_over(game) == 1
+    # Две мины при трёх жизнях: партия заканчивается победой
+    assert lib.bs_game_remaining_ships(game) == 0
+    assert outcomes.count(BS_SUNK) == len(SHIPS)
+    assert lib.bs_game_lives(game) == 3 - outcomes.count(BS_MINE)
+    assert lib.bs_game_step(game, ctypes.byref(move)) == BS_GAME_OVER
+    cells = read_cells(lib, game)
+    assert (cells == 1).sum() == 0
+    assert (cells == 3).sum() == sum(length for _, _, length, _ in SHIPS)
+
+
+def test_read_grids_into_numpy(lib, game):
+    assert load(lib, game, SHIPS, MINES) == BS_OK
+    move = Move()
+    for _ in range(5):
+        assert lib.bs_game_step(game, ctypes.byref(move)) == BS_OK
+    for name in ["bs_game_read_ship_probabilities", "bs_game_read_mine_probabilities"]:
+        grid = np.full((10, 10), np.nan)
+        read = getattr(lib, name)
+        assert read(game, grid.ctypes.data_as(ctypes.POINTER(ctypes.c_double)), grid.size) == BS_OK
+        assert np.isfinite(grid).all()
+        small = np.zeros(99)
+        assert read(game, small.ctypes.data_as(ctypes.POINTER(ctypes.c_double)), small.size) == BS_ERROR_BUFFER
+    # Последний выстрел виден в сетке клеток
+    cells = read_cells(lib, game)
+    assert cells[move.y, move.x] in (3, 4, 5)
+    small = np.zeros(99, dtype=np.int8)
+    assert lib.bs_game_read_cells(game, small.ctypes.data_as(ctypes.POINTER(ctypes.c_int8)),
+                                  small.size) == BS_ERROR_BUFFER
+
+
+def run_games(lib, size, seeds, threads):
+    seed_array = (ctypes.c_uint64 * len(seeds))(*seeds)
+    results = (GameResult * len(seeds))()
+    assert lib.bs_run_games(size, seed_array, len(seeds), threads, results) == BS_OK
+    return [(r.seed, r.moves, r.lives_left, r.victory, r.status) for r in results]
+
+
+def test_run_games_is_deterministic(lib):
+    seeds = list(range(100, 164))
+    single = run_games(lib, 10, seeds, 1)
+    assert [r[0] for r in single] == seeds
+    assert all(r[4] == BS_OK for r in single)
+    assert all(r[1] > 0 for r in single)
+    assert run_games(lib, 10, seeds, 1) == single
+    assert run_games(lib, 10, seeds, 4) == single
+    assert run_games(lib, 10, seeds, 0) == single
+    assert run_games(lib, 12, seeds, 2) != single
+
+
+def test_run_games_arguments(lib):
+    results = (GameResult * 1)()
+    seeds = (ctypes.c_uint64 * 1)(1)
+    assert lib.bs_run_games(0, seeds, 1, 1, results) == BS_ERROR_ARGUMENT
+    assert lib.bs_run_games(10, seeds, 1, -1, results) == BS_ERROR_ARGUMENT
+    assert lib.bs_run_games(10, None, 1, 1, results) == BS_ERROR_ARGUMENT
+    assert lib.bs_run_games(10, None, 0, 1, None) == BS_OK
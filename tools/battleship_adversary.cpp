@@ -0,0 +1,207 @@
+// Поиск худших для алгоритма расстановок параллельным отжигом.
+//
+//   battleship_adversary [--size N] [--chains C] [--iterations I] [--objective moves|lives]
+//                        [--temperature T] [--top K] [--seed S] [--out file]
+//
+// Каждая цепочка стартует со случайной расстановки по правилам (calculateFleet,
+// calculateMineCount) и на каждом шаге переносит один корабль или одну мину в
+// другое допустимое место (canPlaceShip / canPlaceMine). Алгоритм детерминирован,
+// поэтому одна партия точно оценивает расстановку.
+// Цель moves — число ходов до победы (проигрыш хуже любой победы),
+// цель lives — потерянные жизни (при равенстве — больше ходов).
+// Худшие K расстановок пишутся в архив партий (см. GameRecord.h) вместе с ходами
+// текущего алгоритма: battleship_replay verify на нём — регрессионная проверка.
+// Архив перезаписывается. Seed записи — seed стартовой расстановки цепочки
+// (S + номер цепочки); сама расстановка — результат отжига и из seed не получается.
+
+#include "../include/GameBoard.h"
+#include "../include/GameRecord.h"
+#include "../include/GameSetup.h"
+#include "../include/Simulation.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    int size = 10;
+    int chains = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    long long iterations = 2000;
+    bool livesObjective = false;
+    double temperature = 5.0;
+    int top = 10;
+    std::uint64_t seed = 1;
+    std::string out = "worst_layouts.bsgr";
+};
+
+struct Scored {
+    double score = 0.0;
+    std::uint64_t seed = 0;  // seed стартовой расстановки цепочки
+    GameResult result;
+    Layout layout;
+};
+
+double objective(const GameResult& result, int size, bool livesObjective) {
+    int cells = size * size;
+    if (livesObjective) {
+        int livesLost = calculateMineCount(size) - result.livesLeft;
+        return livesLost + static_cast<double>(result.moves) / (cells + 1);
+    }
+    return result.moves + (result.victory ? 0 : cells);
+}
+
+// Переносит случайный корабль или мину; false, если новое место не подошло
+bool proposeMove(Layout& layout, GameBoard& board, std::mt19937_64& rng) {
+    int size = layout.size;
+    int items = static_cast<int>(layout.ships.size() + layout.mines.size());
+    if (items == 0) return false;
+    int item = std::uniform_int_distribution<int>(0, items - 1)(rng);
+    std::uniform_int_distribution<int> coord(0, size - 1);
+    int shipCount = static_cast<int>(layout.ships.size());
+
+    // Поле без переносимого элемента
+    board.reset();
+    for (int i = 0; i < shipCount; ++i) {
+        if (i != item) {
+            const auto& ship = layout.ships[i];
+            board.placeShip(ship.x, ship.y, ship.length, ship.horizontal);
+        }
+    }
+    for (int i = 0; i < static_cast<int>(layout.mines.size()); ++i) {
+        if (shipCount + i != item) board.placeMine(layout.mines[i].first, layout.mines[i].second);
+    }
+
+    int x = coord(rng);
+    int y = coord(rng);
+    if (item < shipCount) {
+        auto& ship = layout.ships[item];
+        bool horizontal = std::bernoulli_distribution(0.5)(rng);
+        if (!board.canPlaceShip(x, y, ship.length, horizontal)) return false;
+        ship = {x, y, ship.length, horizontal};
+    } else {
+        if (!board.canPlaceMine(x, y)) return false;
+        layout.mines[item - shipCount] = {x, y};
+    }
+    return true;
+}
+
+void keepWorst(std::vector<Scored>& worst, const Scored& candidate, int top) {
+    worst.push_back(candidate);
+    std::stable_sort(worst.begin(), worst.end(), [](const Scored& a, const Scored& b) { return a.score > b.score; });
+    if (static_cast<int>(worst.size()) > top) worst.resize(top);
+}
+
+bool sameLayout(const Layout& a, const Layout& b) {
+    if (a.ships.size() != b.ships.size() || a.mines != b.mines) return false;
+    for (size_t i = 0; i < a.ships.size(); ++i) {
+        const auto& s = a.ships[i];
+        const auto& t = b.ships[i];
+        if (s.x != t.x || s.y != t.y || s.length != t.length || s.horizontal != t.horizontal) return false;
+    }
+    return true;
+}
+
+void runChain(const Options& options, int chain, std::vector<Scored>& worst) {
+    std::mt19937_64 rng(options.seed * 1000003 + static_cast<std::uint64_t>(chain));
+    Scored current;
+    current.seed = options.seed + static_cast<std::uint64_t>(chain);
+    if (!generateRandomLayout(options.size, current.seed, current.layout)) return;
+    current.result = playGame(current.layout);
+    current.score = objective(current.result, options.size, options.livesObjective);
+    keepWorst(worst, current, options.top);
+
+    GameBoard board(options.size);
+    Scored next;
+    next.seed = current.seed;
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    for (long long it = 0; it < options.iterations; ++it) {
+        // Геометрическое охлаждение до 1% от начальной температуры
+        double progress = static_cast<double>(it) / std::max(1LL, options.iterations - 1);
+        double temperature = options.temperature * std::pow(0.01, progress);
+
+        next.layout = current.layout;
+        if (!proposeMove(next.layout, board, rng)) continue;
+        next.result = playGame(next.layout);
+        next.score = objective(next.result, options.size, options.livesObjective);
+        if (next.score >= current.score || unit(rng) < std::exp((next.score - current.score) / temperature)) {
+            std::swap(current, next);
+            if (worst.size() < static_cast<size_t>(options.top) || current.score > worst.back().score) {
+                bool duplicate = false;
+                for (const auto& w : worst) duplicate = duplicate || sameLayout(w.layout, current.layout);
+                if (!duplicate) keepWorst(worst, current, options.top);
+            }
+        }
+    }
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string key = argv[i];
+        std::string value = argv[i + 1];
+        if (key == "--size") options.size = std::stoi(value);
+        else if (key == "--chains") options.chains = std::stoi(value);
+        else if (key == "--iterations") options.iterations = std::stoll(value);
+        else if (key == "--objective" && (value == "moves" || value == "lives")) options.livesObjective = value == "lives";
+        else if (key == "--temperature") options.temperature = std::stod(value);
+        else if (key == "--top") options.top = std::stoi(value);
+        else if (key == "--seed") options.seed = std::stoull(value);
+        else if (key == "--out") options.out = value;
+        else return false;
+    }
+    return argc % 2 == 1 && options.size >= 1 && options.chains >= 1 && options.iterations >= 0 &&
+           options.temperature > 0.0 && options.top >= 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        Options options;
+        if (!parseOptions(argc, argv, options)) {
+            std::cerr << "Usage: battleship_adversary [--size N] [--chains C] [--iterations I]\n"
+                      << "                            [--objective moves|lives] [--temperature T]\n"
+                      << "                            [--top K] [--seed S] [--out file]\n";
+            return 1;
+        }
+
+        std::vector<std::vector<Scored>> perChain(options.chains);
+        std::vector<std::thread> workers;
+        for (int chain = 0; chain < options.chains; ++chain) {
+            workers.emplace_back([&, chain]() { runChain(options, chain, perChain[chain]); });
+        }
+        for (auto& worker : workers) worker.join();
+
+        std::vector<Scored> worst;
+        for (const auto& chainWorst : perChain) {
+            for (const auto& candidate : chainWorst) {
+                bool duplicate = false;
+                for (const auto& w : worst) duplicate = duplicate || sameLayout(w.layout, candidate.layout);
+                if (!duplicate) keepWorst(worst, candidate, options.top);
+            }
+        }
+
+        // Перезапуск не должен дублировать записи прошлого прогона
+        GameRecordWriter writer(options.out, true);
+        std::vector<MoveRecord> moves;
+        int maxLives = calculateMineCount(options.size);
+        std::cout << "Worst layouts (" << (options.livesObjective ? "lives lost" : "moves to win") << "):\n";
+        for (size_t i = 0; i < worst.size(); ++i) {
+            GameResult result = playGame(worst[i].layout, &moves);
+            writer.append(worst[i].layout, worst[i].seed, maxLives, result, moves);
+            std::cout << "  #" << i << " (chain seed " << worst[i].seed << "): moves " << result.moves << ", lives lost " << (maxLives - result.livesLeft)
+                      << (result.victory ? ", won" : ", lost") << "\n";
+        }
+        writer.flush();
+        std::cout << "Saved " << worst.size() << " layouts to " << options.out << "\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,117 @@
+// Построение дебютной книги (см. OpeningBook.h).
+//
+//   battleship_book <file> <size> [--games G] [--depth D] [--seed S] [--threads T] [--min-votes V]
+//
+// Играет G партий на случайных расстановках и для каждой истории наблюдений
+// первых D ходов запоминает, куда стрелял алгоритм. Алгоритм видит часть скрытого
+// поля (штраф за соседей), поэтому при одной истории ходы иногда расходятся:
+// в книгу идёт самый частый ход, если его выбрали не меньше V раз.
+
+#include "../include/GameSetup.h"
+#include "../include/OpeningBook.h"
+#include "../include/Simulation.h"
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Голоса за клетки при одной истории
+using Votes = std::unordered_map<int, int>;
+using VoteTable = std::unordered_map<std::uint64_t, Votes>;
+
+void collectVotes(int size, long long games, std::uint64_t seed, int depth, int thread, int threads,
+                  VoteTable& table) {
+    Layout layout;
+    std::vector<MoveRecord> moves;
+    for (long long game = thread; game < games; game += threads) {
+        if (!generateRandomLayout(size, seed + static_cast<std::uint64_t>(game), layout)) continue;
+        playGame(layout, &moves);
+        std::uint64_t key = OpeningBook::kRootKey;
+        int count = std::min(depth, static_cast<int>(moves.size()));
+        for (int i = 0; i < count; ++i) {
+            int cell = moves[i].y * size + moves[i].x;
+            table[key][cell]++;
+            key = OpeningBook::extendKey(key, cell, moves[i].outcome);
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        if (argc < 3) {
+            std::cerr << "Usage: battleship_book <file> <size> [--games G] [--depth D] [--seed S]"
+                      << " [--threads T] [--min-votes V]\n";
+            return 1;
+        }
+        std::string path = argv[1];
+        int size = std::stoi(argv[2]);
+        long long games = 10000;
+        int depth = 12;
+        std::uint64_t seed = 1;
+        int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        int minVotes = 2;
+        for (int i = 3; i + 1 < argc; i += 2) {
+            std::string key = argv[i];
+            std::string value = argv[i + 1];
+            if (key == "--games") games = std::stoll(value);
+            else if (key == "--depth") depth = std::stoi(value);
+            else if (key == "--seed") seed = std::stoull(value);
+            else if (key == "--threads") threads = std::max(1, std::stoi(value));
+            else if (key == "--min-votes") minVotes = std::max(1, std::stoi(value));
+            else throw std::runtime_error("Unknown option " + key);
+        }
+        if (size < 1 || depth < 1) throw std::runtime_error("Size and depth must be positive");
+
+        std::vector<VoteTable> tables(threads);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t]() { collectVotes(size, games, seed, depth, t, threads, tables[t]); });
+        }
+        for (auto& worker : workers) worker.join();
+        for (int t = 1; t < threads; ++t) {
+            for (const auto& [key, votes] : tables[t]) {
+                for (const auto& [cell, count] : votes) tables[0][key][cell] += count;
+            }
+            VoteTable().swap(tables[t]);
+        }
+
+        std::vector<OpeningBookEntry> entries;
+        long long totalVotes = 0;
+        long long agreeingVotes = 0;
+        for (const auto& [key, votes] : tables[0]) {
+            OpeningBookEntry best{key, -1, 0};
+            for (const auto& [cell, count] : votes) {
+                totalVotes += count;
+                if (count > best.votes || (count == best.votes && cell < best.cell)) {
+                    best.cell = cell;
+                    best.votes = count;
+                }
+            }
+            if (best.votes >= minVotes) {
+                entries.push_back(best);
+                agreeingVotes += best.votes;
+            }
+        }
+        // Порядок записей не зависит от обхода хеш-таблицы — файл воспроизводим
+        std::sort(entries.begin(), entries.end(),
+                  [](const OpeningBookEntry& a, const OpeningBookEntry& b) { return a.key < b.key; });
+        // playGame играет с calculateMineCount жизнями и параметрами по умолчанию
+        OpeningBook::write(path, size, calculateMineCount(size), AlgorithmParams(), depth, entries);
+
+        std::cout << "Histories: " << tables[0].size() << ", book entries: " << entries.size() << "\n";
+        std::cout << "Moves covered by the book: "
+                  << (totalVotes > 0 ? 100.0 * agreeingVotes / totalVotes : 0.0) << "%\n";
+        std::cout << "Saved to " << path << "\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
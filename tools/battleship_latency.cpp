@@ -0,0 +1,158 @@
+// Замер задержки выбора хода при заданном бюджете.
+//
+//   battleship_latency [--size N] [--games G] [--budget-us B] [--seed S] [--move-threads T]
+//                      [--endgame-layouts L] [--endgame-nodes K] [--book file]
+//
+// B = 0 — без ограничения. T > 0 включает параллельную оценку клеток внутри хода
+// на пуле из T потоков для любых размеров поля: порог kDefaultParallelMinSize здесь
+// снят, поэтому на малых полях замер показывает накладные расходы пула, которых в
+// обычной игре нет. L > 0 включает точный эндшпиль,
+// когда согласных расстановок не больше L, с пределом K узлов на ход; перебор
+// запускается только в конце партии (см. EndgameSolver) и получает половину бюджета.
+// --book подключает дебютную книгу (см. battleship_book).
+// Печатает перцентили времени makeMove целиком и отдельно выбора клетки (бюджет
+// ограничивает только выбор, выстрел и пересчёт вероятностей идут сверх него), долю ходов, где уточнение дошло до конца,
+// и распределение по последнему пройденному этапу, чтобы подобрать бюджет под целевой p99.
+
+#include "../include/GameBoard.h"
+#include "../include/BattleshipAlgorithm.h"
+#include "../include/EndgameSolver.h"
+#include "../include/GameSetup.h"
+#include "../include/OpeningBook.h"
+#include "../include/Statistics.h"
+#include "../include/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* stageName(SearchStage stage) {
+    switch (stage) {
+        case SearchStage::None: return "none";
+        case SearchStage::Fallback: return "fallback";
+        case SearchStage::Kill: return "kill";
+        case SearchStage::LastHit: return "last-hit";
+        case SearchStage::Candidates: return "candidates";
+        case SearchStage::Pattern: return "pattern";
+        case SearchStage::FullBoard: return "full-board";
+        case SearchStage::Endgame: return "endgame";
+        case SearchStage::Book: return "book";
+    }
+    return "?";
+}
+
+double percentile(const std::vector<double>& sorted, double q) {
+    if (sorted.empty()) return 0.0;
+    size_t index = static_cast<size_t>(q * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[index];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        int size = 10;
+        int games = 100;
+        long long budgetMicros = 0;
+        std::uint64_t seed = 1;
+        int moveThreads = 0;
+        int endgameLayouts = 0;
+        int endgameNodes = EndgameSolver::kDefaultNodeBudget;
+        std::string bookPath;
+        for (int i = 1; i + 1 < argc; i += 2) {
+            std::string key = argv[i];
+            std::string value = argv[i + 1];
+            if (key == "--size") size = std::stoi(value);
+            else if (key == "--games") games = std::stoi(value);
+            else if (key == "--budget-us") budgetMicros = std::stoll(value);
+            else if (key == "--seed") seed = std::stoull(value);
+            else if (key == "--move-threads") moveThreads = std::stoi(value);
+            else if (key == "--endgame-layouts") endgameLayouts = std::stoi(value);
+            else if (key == "--endgame-nodes") endgameNodes = std::stoi(value);
+            else if (key == "--book") bookPath = value;
+            else {
+                std::cerr << "Usage: battleship_latency [--size N] [--games G] [--budget-us B] [--seed S]"
+                          << " [--move-threads T]\n"
+                          << "                          [--endgame-layouts L] [--endgame-nodes K] [--book file]\n";
+                return 1;
+            }
+        }
+
+        std::unique_ptr<ThreadPool> pool;
+        if (moveThreads > 0) pool = std::make_unique<ThreadPool>(moveThreads);
+        std::unique_ptr<EndgameSolver> endgame;
+        if (endgameLayouts > 0) endgame = std::make_unique<EndgameSolver>(endgameLayouts, endgameNodes);
+        std::unique_ptr<OpeningBook> book;
+        if (!bookPath.empty()) book = std::make_unique<OpeningBook>(bookPath);
+
+        std::vector<double> latencies;
+        std::vector<double> searchLatencies;
+        std::vector<long long> stageCounts(static_cast<int>(SearchStage::Book) + 1, 0);
+        long long completeMoves = 0;
+        RunningStats moves;
+        std::uint64_t wins = 0;
+        Layout layout;
+        auto board = std::make_shared<GameBoard>(size);
+        for (int game = 0; game < games; ++game) {
+            if (!generateRandomLayout(size, seed + static_cast<std::uint64_t>(game), layout) ||
+                !applyLayout(*board, layout)) {
+                throw std::runtime_error("Cannot generate layout");
+            }
+            BattleshipAlgorithm algorithm(board, calculateMineCount(size));
+            // Порог 1: параллельно на любом поле, см. комментарий в начале файла
+            if (pool) algorithm.setThreadPool(pool.get(), 1);
+            algorithm.setEndgameSolver(endgame.get());
+            algorithm.setOpeningBook(book.get());
+            int gameMoves = 0;
+            while (!board->isVictory() && algorithm.getCurrentLives() > 0) {
+                if (budgetMicros > 0) {
+                    algorithm.makeMove(std::chrono::steady_clock::now() + std::chrono::microseconds(budgetMicros));
+                } else {
+                    algorithm.makeMove();
+                }
+                if (algorithm.getLastMove().first == -1) break;
+                const auto& report = algorithm.getLastReport();
+                latencies.push_back(report.elapsedMicros);
+                searchLatencies.push_back(report.searchMicros);
+                stageCounts[static_cast<int>(report.stage)]++;
+                if (report.complete) completeMoves++;
+                gameMoves++;
+            }
+            moves.add(gameMoves);
+            if (board->isVictory()) wins++;
+        }
+
+        std::sort(latencies.begin(), latencies.end());
+        std::sort(searchLatencies.begin(), searchLatencies.end());
+        std::cout << "Moves: " << latencies.size() << ", budget: "
+                  << (budgetMicros > 0 ? std::to_string(budgetMicros) + " us" : std::string("unlimited")) << "\n";
+        auto printLatency = [](const char* title, const std::vector<double>& sorted) {
+            std::cout << title << ", us: p50 " << percentile(sorted, 0.50)
+                      << ", p90 " << percentile(sorted, 0.90)
+                      << ", p99 " << percentile(sorted, 0.99)
+                      << ", max " << (sorted.empty() ? 0.0 : sorted.back()) << "\n";
+        };
+        printLatency("makeMove latency", latencies);
+        printLatency("Search latency", searchLatencies);
+        std::cout << "Complete refinement: "
+                  << (latencies.empty() ? 0.0 : 100.0 * completeMoves / latencies.size()) << "%\n";
+        std::cout << "Last stage reached:\n";
+        for (size_t s = 0; s < stageCounts.size(); ++s) {
+            if (stageCounts[s] > 0) {
+                std::cout << "  " << stageName(static_cast<SearchStage>(s)) << ": " << stageCounts[s] << "\n";
+            }
+        }
+        Interval survival = wilsonInterval(wins, static_cast<std::uint64_t>(games));
+        std::cout << "Games: " << games << ", mean moves " << moves.mean()
+                  << ", survival " << survival.value << " [" << survival.low << ", " << survival.high << "]\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,118 @@
+// Пакетная проверка расстановок (формат — см. LayoutLoader.h).
+//
+//   battleship_layouts check <file> [--out archive] [--errors file] [--threads T]
+//   battleship_layouts generate <file> <size> <count> [seed]
+//
+// check проверяет все строки файла; правильные расстановки пишутся в архив
+// (--out создаёт его заново) записями layoutOnly — сыграть их можно через
+// battleship_stats --layouts. Ошибки печатаются в stderr или в файл. generate пишет
+// случайные правильные расстановки — пример формата и вход для замеров.
+
+#include "../include/GameRecord.h"
+#include "../include/GameSetup.h"
+#include "../include/LayoutLoader.h"
+#include "../include/ThreadPool.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace {
+
+void printUsage() {
+    std::cerr << "Usage:\n"
+              << "  battleship_layouts check <file> [--out archive] [--errors file] [--threads T]\n"
+              << "  battleship_layouts generate <file> <size> <count> [seed]\n";
+}
+
+int runCheck(int argc, char** argv) {
+    std::string path = argv[2];
+    std::string outPath;
+    std::string errorsPath;
+    int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int i = 3; i + 1 < argc; i += 2) {
+        std::string key = argv[i];
+        std::string value = argv[i + 1];
+        if (key == "--out") outPath = value;
+        else if (key == "--errors") errorsPath = value;
+        else if (key == "--threads") threads = std::max(1, std::stoi(value));
+        else throw std::runtime_error("Unknown option " + key);
+    }
+
+    std::unique_ptr<GameRecordWriter> archive;
+    if (!outPath.empty()) archive = std::make_unique<GameRecordWriter>(outPath, true);
+    std::ofstream errorsFile;
+    if (!errorsPath.empty()) {
+        errorsFile.open(errorsPath);
+        if (!errorsFile) throw std::runtime_error("Cannot open " + errorsPath + " for writing");
+    }
+    // Вызывающий поток тоже проверяет куски, поэтому в пуле на один поток меньше
+    std::unique_ptr<ThreadPool> pool;
+    if (threads > 1) pool = std::make_unique<ThreadPool>(threads - 1);
+
+    auto start = std::chrono::steady_clock::now();
+    LayoutLoader loader(pool.get());
+    LayoutLoadStats stats = loader.load(path, archive.get(), errorsPath.empty() ? &std::cerr : &errorsFile);
+    if (archive) archive->flush();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Layouts: " << stats.lines << ", valid: " << stats.valid << ", invalid: " << stats.invalid << "\n";
+    std::cout << "Time: " << seconds << " s, " << (seconds > 0 ? stats.lines / seconds : 0.0) << " layouts/s, "
+              << (seconds > 0 ? stats.bytes / seconds / (1 << 20) : 0.0) << " MiB/s\n";
+    return stats.invalid == 0 ? 0 : 2;
+}
+
+int runGenerate(int argc, char** argv) {
+    if (argc < 5) {
+        printUsage();
+        return 1;
+    }
+    std::string path = argv[2];
+    int size = std::stoi(argv[3]);
+    long long count = std::stoll(argv[4]);
+    std::uint64_t seed = argc > 5 ? std::stoull(argv[5]) : 1;
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) throw std::runtime_error("Cannot open " + path + " for writing");
+    Layout layout;
+    std::string buffer;
+    bool ok = true;
+    long long generated = 0;
+    for (long long i = 0; i < count && ok; ++i) {
+        if (!generateRandomLayout(size, seed + static_cast<std::uint64_t>(i), layout)) continue;
+        appendLayoutLine(buffer, layout);
+        generated++;
+        if (buffer.size() >= (1 << 20)) {
+            ok = std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+            buffer.clear();
+        }
+    }
+    ok = ok && std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) throw std::runtime_error("Failed to write " + path);
+    std::cout << "Generated " << generated << " layouts into " << path << "\n";
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        if (argc < 3) {
+            printUsage();
+            return 1;
+        }
+        std::string command = argv[1];
+        if (command == "check") return runCheck(argc, argv);
+        if (command == "generate") return runGenerate(argc, argv);
+        printUsage();
+        return 1;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,224 @@
+// Запись и проверка архива партий.
+//
+//   battleship_replay record <file> <size> <games> [seed] [threads]
+//   battleship_replay verify <file> [--max-reports N]
+//
+// record играет партии на случайных расстановках и дописывает их в архив.
+// verify проигрывает каждую запись через GameBoard::makeShot, сверяет исходы
+// и проверяет, повторяет ли текущий BattleshipAlgorithm записанные ходы.
+// У расстановок без партии (layoutOnly) проверяется только сама расстановка.
+
+#include "../include/GameBoard.h"
+#include "../include/BattleshipAlgorithm.h"
+#include "../include/GameRecord.h"
+#include "../include/GameSetup.h"
+#include "../include/Simulation.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const char* outcomeName(ShotOutcome outcome) {
+    switch (outcome) {
+        case ShotOutcome::Miss: return "miss";
+        case ShotOutcome::Hit: return "hit";
+        case ShotOutcome::Mine: return "mine";
+        case ShotOutcome::Sunk: return "sunk";
+    }
+    return "?";
+}
+
+void printUsage() {
+    std::cerr << "Usage:\n"
+              << "  battleship_replay record <file> <size> <games> [seed] [threads]\n"
+              << "  battleship_replay verify <file> [--max-reports N]\n";
+}
+
+int record(const std::string& path, int size, long long games, std::uint64_t seed, int threads) {
+    GameRecordWriter writer(path);
+    std::atomic<long long> failed{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            Layout layout;
+            std::vector<MoveRecord> moves;
+            for (long long game = t; game < games; game += threads) {
+                std::uint64_t gameSeed = seed + static_cast<std::uint64_t>(game);
+                if (!generateRandomLayout(size, gameSeed, layout)) {
+                    failed++;
+                    continue;
+                }
+                GameResult result = playGame(layout, &moves);
+                writer.append(layout, gameSeed, calculateMineCount(size), result, moves);
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    writer.flush();
+
+    std::cout << "Recorded " << (games - failed) << " games to " << path << "\n";
+    if (failed > 0) {
+        std::cerr << "Failed to generate layout for " << failed << " games\n";
+        return 1;
+    }
+    return 0;
+}
+
+// Поле и алгоритм одного размера живут всю проверку, чтобы записи не выделяли память
+struct Replayer {
+    std::shared_ptr<GameBoard> board;
+    std::unique_ptr<BattleshipAlgorithm> algorithm;
+};
+
+enum class Verdict { Reproduced, Diverged, Corrupted, LayoutOnly };
+
+template <class Report>
+Verdict verifyRecord(const GameRecordView& view, Layout& layout, Replayer& replayer, const Report& report) {
+    const auto& header = view.header();
+    GameBoard& board = *replayer.board;
+    view.readLayout(layout);
+    if (!applyLayout(board, layout)) {
+        report("layout violates placement rules");
+        return Verdict::Corrupted;
+    }
+    // Партия не сыграна — сверять нечего
+    if (header.layoutOnly) return Verdict::LayoutOnly;
+
+    // 1. Записанные ходы должны давать те же исходы на этой расстановке
+    auto cursor = view.moves();
+    MoveRecord move;
+    for (int k = 0; cursor.next(move); ++k) {
+        bool hit = board.makeShot(move.x, move.y);
+        ShotOutcome actual = classifyShot(board, move.x, move.y, hit);
+        if (actual != move.outcome) {
+            report("move " + std::to_string(k + 1) + " at (" + std::to_string(move.x) + ", " +
+                   std::to_string(move.y) + ") recorded as " + outcomeName(move.outcome) +
+                   ", board gives " + outcomeName(actual));
+            return Verdict::Corrupted;
+        }
+    }
+
+    // 2. Текущий алгоритм должен повторить ту же последовательность
+    applyLayout(board, layout);
+    if (!replayer.algorithm) {
+        replayer.algorithm = std::make_unique<BattleshipAlgorithm>(replayer.board, header.maxLives);
+    } else {
+        replayer.algorithm->reset(header.maxLives);
+    }
+    BattleshipAlgorithm& algorithm = *replayer.algorithm;
+    cursor = view.moves();
+    int k = 0;
+    for (; cursor.next(move); ++k) {
+        algorithm.makeMove();
+        auto [x, y] = algorithm.getLastMove();
+        if (x != move.x || y != move.y) {
+            report("diverged at move " + std::to_string(k + 1) + ": recorded (" + std::to_string(move.x) + ", " +
+                   std::to_string(move.y) + ") " + outcomeName(move.outcome) + ", engine (" + std::to_string(x) +
+                   ", " + std::to_string(y) + ")");
+            return Verdict::Diverged;
+        }
+    }
+    if (!board.isVictory() && algorithm.getCurrentLives() > 0) {
+        algorithm.makeMove();
+        if (algorithm.getLastMove().first != -1) {
+            report("engine continues after recorded end at move " + std::to_string(k));
+            return Verdict::Diverged;
+        }
+    }
+    return Verdict::Reproduced;
+}
+
+int verify(const std::string& path, long long maxReports) {
+    GameRecordReader reader(path);
+    GameRecordView view;
+    Layout layout;
+    std::map<int, Replayer> replayers;
+    long long total = 0, reproduced = 0, diverged = 0, corrupted = 0, layoutsOnly = 0;
+
+    long long reports = 0;
+    auto print = [&](long long index, const std::string& seed, const std::string& message) {
+        if (reports++ < maxReports) std::cout << "game " << index << " (seed " << seed << "): " << message << "\n";
+    };
+
+    while (true) {
+        long long index = total;
+        std::size_t offset = reader.offset();
+        try {
+            if (!reader.next(view)) break;
+        } catch (const std::exception& e) {
+            total++;
+            corrupted++;
+            print(index, "?", e.what());
+            // Испорчена длина записи — следующую уже не найти
+            if (reader.offset() == offset) break;
+            continue;
+        }
+        total++;
+        const auto& header = view.header();
+        auto report = [&](const std::string& message) { print(index, std::to_string(header.seed), message); };
+        // Испорченная запись (расстановка, поток ходов) не прерывает проверку остальных
+        try {
+            Replayer& replayer = replayers[header.size];
+            if (!replayer.board) replayer.board = std::make_shared<GameBoard>(header.size);
+            switch (verifyRecord(view, layout, replayer, report)) {
+                case Verdict::Reproduced: reproduced++; break;
+                case Verdict::Diverged: diverged++; break;
+                case Verdict::Corrupted: corrupted++; break;
+                case Verdict::LayoutOnly: layoutsOnly++; break;
+            }
+        } catch (const std::exception& e) {
+            corrupted++;
+            report(e.what());
+        }
+    }
+
+    std::cout << "Games: " << total << ", reproduced: " << reproduced
+              << ", diverged: " << diverged << ", corrupted: " << corrupted;
+    if (layoutsOnly > 0) std::cout << ", layouts without games: " << layoutsOnly;
+    std::cout << "\n";
+    return (diverged == 0 && corrupted == 0) ? 0 : 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        if (argc < 3) {
+            printUsage();
+            return 1;
+        }
+        std::string command = argv[1];
+        std::string path = argv[2];
+        if (command == "record" && argc >= 5) {
+            int size = std::stoi(argv[3]);
+            long long games = std::stoll(argv[4]);
+            std::uint64_t seed = argc > 5 ? std::stoull(argv[5]) : 1;
+            int threads = argc > 6 ? std::stoi(argv[6])
+                                   : std::max(1u, std::thread::hardware_concurrency());
+            if (size < 1 || games < 0 || threads < 1) {
+                printUsage();
+                return 1;
+            }
+            return record(path, size, games, seed, threads);
+        }
+        if (command == "verify") {
+            long long maxReports = 20;
+            if (argc > 4 && std::string(argv[3]) == "--max-reports") {
+                maxReports = std::stoll(argv[4]);
+            }
+            return verify(path, maxReports);
+        }
+        printUsage();
+        return 1;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,181 @@
+// Массовая симуляция со сводкой результатов без хранения партий.
+//
+//   battleship_stats [--sizes 10,12,20] [--games G] [--seed S] [--threads T]
+//                    [--checkpoint SEC] [--csv file] [--json file] [--layouts archive]
+//
+// Для каждого размера играется G партий на случайных расстановках (seed + номер партии).
+// С --layouts партии играются на расстановках из архива партий (например, из
+// battleship_layouts check --out) — по одной на запись; --sizes, --games и --seed не нужны.
+// Каждый поток пишет в свой накопитель ResultAggregator; раз в SEC секунд главный
+// поток печатает промежуточный снимок, не останавливая писателей. Итоговая сводка
+// (CSV-таблица по размерам) печатается в stdout или пишется в файлы.
+
+#include "../include/GameRecord.h"
+#include "../include/GameSetup.h"
+#include "../include/ResultAggregator.h"
+#include "../include/Simulation.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::vector<int> sizes = {10};
+    long long games = 1000;
+    std::uint64_t seed = 1;
+    int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    double checkpointSeconds = 5.0;
+    std::string csvPath;
+    std::string jsonPath;
+    std::string layoutsPath;
+};
+
+std::vector<int> parseSizes(const std::string& text) {
+    std::vector<int> sizes;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) sizes.push_back(std::stoi(item));
+    return sizes;
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string key = argv[i];
+        if (i + 1 >= argc) return false;
+        std::string value = argv[++i];
+        if (key == "--sizes") options.sizes = parseSizes(value);
+        else if (key == "--games") options.games = std::stoll(value);
+        else if (key == "--seed") options.seed = std::stoull(value);
+        else if (key == "--threads") options.threads = std::stoi(value);
+        else if (key == "--checkpoint") options.checkpointSeconds = std::stod(value);
+        else if (key == "--csv") options.csvPath = value;
+        else if (key == "--json") options.jsonPath = value;
+        else if (key == "--layouts") options.layoutsPath = value;
+        else return false;
+    }
+    for (int size : options.sizes) {
+        if (size < 1) return false;
+    }
+    return !options.sizes.empty() && options.games >= 1 && options.threads >= 1;
+}
+
+// Размеры полей в архиве; заодно проверяет, что все расстановки читаются,
+// чтобы потоки-игроки не споткнулись о повреждённую запись
+std::vector<int> archiveSizes(const std::string& path) {
+    GameRecordReader reader(path);
+    GameRecordView view;
+    Layout layout;
+    std::set<int> sizes;
+    while (reader.next(view)) {
+        view.readLayout(layout);
+        sizes.insert(view.header().size);
+    }
+    return std::vector<int>(sizes.begin(), sizes.end());
+}
+
+void printCheckpoint(const std::vector<SizeSummary>& summary, double elapsed) {
+    std::cout << "[" << elapsed << " s]";
+    for (const auto& entry : summary) {
+        if (entry.size == 0) continue;
+        Interval survival = wilsonInterval(entry.wins, entry.games);
+        std::cout << "  " << entry.size << "x" << entry.size << ": " << entry.games << " games, survival "
+                  << survival.value << ", moves " << histogramMean(entry.movesToWin).value;
+    }
+    std::cout << std::endl;
+}
+
+void writeFile(const std::string& path, const std::vector<SizeSummary>& summary, bool json) {
+    std::ofstream out(path);
+    if (!out) throw std::runtime_error("Cannot open " + path + " for writing");
+    if (json) writeSummaryJson(out, summary);
+    else writeSummaryCsv(out, summary);
+    if (!out) throw std::runtime_error("Failed to write " + path);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        Options options;
+        if (!parseOptions(argc, argv, options)) {
+            std::cerr << "Usage: battleship_stats [--sizes 10,12,20] [--games G] [--seed S] [--threads T]\n"
+                      << "                        [--checkpoint SEC] [--csv file] [--json file] [--layouts archive]\n";
+            return 1;
+        }
+        std::unique_ptr<GameRecordReader> archive;
+        std::mutex archiveMutex;
+        if (!options.layoutsPath.empty()) {
+            options.sizes = archiveSizes(options.layoutsPath);
+            if (options.sizes.empty()) throw std::runtime_error("No layouts in " + options.layoutsPath);
+            archive = std::make_unique<GameRecordReader>(options.layoutsPath);
+        }
+
+        ResultAggregator aggregator(options.sizes, options.threads);
+        long long total = options.games * static_cast<long long>(options.sizes.size());
+        std::atomic<long long> next{0};
+        std::atomic<int> running{options.threads};
+        // Следующая расстановка: из архива (чтение под мьютексом) или случайная
+        auto nextLayout = [&](Layout& layout) {
+            if (archive) {
+                std::lock_guard<std::mutex> lock(archiveMutex);
+                GameRecordView view;
+                if (!archive->next(view)) return false;
+                view.readLayout(layout);
+                return true;
+            }
+            for (long long i = next++; i < total; i = next++) {
+                int size = options.sizes[static_cast<size_t>(i / options.games)];
+                std::uint64_t gameSeed = options.seed + static_cast<std::uint64_t>(i % options.games);
+                if (generateRandomLayout(size, gameSeed, layout)) return true;
+            }
+            return false;
+        };
+        auto worker = [&](int thread) {
+            Layout layout;
+            std::vector<MoveRecord> moves;
+            while (nextLayout(layout)) {
+                GameResult result = playGame(layout, &moves);
+                aggregator.record(thread, layout, result, moves);
+            }
+            running--;
+        };
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (int t = 0; t < options.threads; ++t) workers.emplace_back(worker, t);
+        // Промежуточные снимки: писатели не ждут читателя
+        auto interval = std::chrono::duration<double>(std::max(0.1, options.checkpointSeconds));
+        auto nextCheckpoint = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(interval);
+        while (running > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            auto now = std::chrono::steady_clock::now();
+            if (now >= nextCheckpoint && running > 0) {
+                printCheckpoint(aggregator.snapshot(), std::chrono::duration<double>(now - start).count());
+                nextCheckpoint = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(interval);
+            }
+        }
+        for (auto& w : workers) w.join();
+
+        auto summary = aggregator.snapshot();
+        if (!options.csvPath.empty()) writeFile(options.csvPath, summary, false);
+        if (!options.jsonPath.empty()) writeFile(options.jsonPath, summary, true);
+        if (options.csvPath.empty() && options.jsonPath.empty()) writeSummaryCsv(std::cout, summary);
+        std::cout << "Games: " << summary.back().games << " in "
+                  << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,70 @@
+// Трассировка партий в .npy для анализа в Python.
+//
+//   battleship_trace <file.npy> <size> <games> [seed] [threads]
+//
+// Каждый поток играет свои партии и копит кадры в собственном буфере,
+// в файл они уходят пачками. Чтение: numpy.load(file, mmap_mode="r").
+
+#include "../include/GameBoard.h"
+#include "../include/BattleshipAlgorithm.h"
+#include "../include/GameSetup.h"
+#include "../include/MoveTrace.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+int main(int argc, char** argv) {
+    try {
+        if (argc < 4) {
+            std::cerr << "Usage: battleship_trace <file.npy> <size> <games> [seed] [threads]\n";
+            return 1;
+        }
+        std::string path = argv[1];
+        int size = std::stoi(argv[2]);
+        long long games = std::stoll(argv[3]);
+        std::uint64_t seed = argc > 4 ? std::stoull(argv[4]) : 1;
+        int threads = argc > 5 ? std::stoi(argv[5]) : std::max(1u, std::thread::hardware_concurrency());
+        if (size < 1 || games < 0 || threads < 1) {
+            std::cerr << "Error: invalid arguments\n";
+            return 1;
+        }
+
+        MoveTraceWriter writer(path, size);
+        std::atomic<long long> failed{0};
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t]() {
+                MoveTraceBuffer trace(writer);
+                Layout layout;
+                auto board = std::make_shared<GameBoard>(size);
+                for (long long game = t; game < games; game += threads) {
+                    if (!generateRandomLayout(size, seed + static_cast<std::uint64_t>(game), layout) ||
+                        !applyLayout(*board, layout)) {
+                        failed++;
+                        continue;
+                    }
+                    BattleshipAlgorithm algorithm(board, calculateMineCount(size));
+                    algorithm.setTrace(&trace, static_cast<std::uint32_t>(game));
+                    while (!board->isVictory() && algorithm.getCurrentLives() > 0) {
+                        algorithm.makeMove();
+                        if (algorithm.getLastMove().first == -1) break;
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+        writer.close();
+
+        std::cout << "Traced " << (games - failed) << " games, " << writer.getFrameCount()
+                  << " frames to " << path << "\n";
+        return failed > 0 ? 1 : 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,244 @@
+// Подбор констант эвристик BattleshipAlgorithm методом последовательного отсева
+// (successive halving).
+//
+//   battleship_tune [--size N] [--candidates K] [--games G] [--eta E]
+//                   [--seed S] [--threads T] [--loss-penalty P] [--holdout H]
+//
+// Кандидат 0 — параметры по умолчанию, остальные выбираются случайно из диапазонов.
+// На каждом раунде выжившие кандидаты доигрывают партии до бюджета G * E^r и
+// лучшие 1/E проходят дальше. Все кандидаты играют на одних и тех же расстановках
+// (общие случайные числа), поэтому разница между ними не тонет в шуме расстановок.
+// Оценка кандидата: среднее число ходов, проигранная партия стоит P ходов.
+// Победитель отобран на тех же партиях, поэтому его оценка на них завышена; итоговые
+// интервалы считаются заново на H отложенных расстановках, не участвовавших в отборе
+// (по умолчанию H — бюджет последнего раунда).
+
+#include "../include/BattleshipAlgorithm.h"
+#include "../include/GameSetup.h"
+#include "../include/Simulation.h"
+#include "../include/Statistics.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct Options {
+    int size = 10;
+    int candidates = 32;
+    long long games = 50;
+    int eta = 2;
+    std::uint64_t seed = 1;
+    int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    double lossPenalty = -1.0;  // по умолчанию 2 * N²
+    long long holdout = 0;      // по умолчанию — бюджет последнего раунда
+};
+
+// Предел партий на кандидата: все расстановки последнего раунда хранятся в памяти
+const long long kMaxGames = 10000000;
+
+struct Candidate {
+    AlgorithmParams params;
+    std::vector<GameResult> results;  // по индексу расстановки
+};
+
+double score(const GameResult& result, double lossPenalty) {
+    return result.victory ? result.moves : lossPenalty;
+}
+
+double meanScore(const Candidate& candidate, long long games, double lossPenalty) {
+    double sum = 0.0;
+    for (long long i = 0; i < games; ++i) sum += score(candidate.results[i], lossPenalty);
+    return games > 0 ? sum / games : 0.0;
+}
+
+AlgorithmParams sampleParams(std::mt19937_64& rng) {
+    auto uniform = [&](double low, double high) {
+        return std::uniform_real_distribution<double>(low, high)(rng);
+    };
+    AlgorithmParams params;
+    params.lambdaMax = uniform(0.0, 10.0);
+    params.riskExponent = uniform(-6.0, 0.0);
+    params.neighborPenalty = uniform(0.0, 0.3);
+    params.shipFactor = uniform(0.0, 1.5);
+    params.mineFactor = uniform(0.0, 1.0);
+    params.mineThreshold = uniform(0.0, 2.0);
+    params.lowLives = std::uniform_int_distribution<int>(1, 4)(rng);
+    return params;
+}
+
+// Доигрывает партии [0, games) для перечисленных кандидатов во всех потоках
+void evaluate(std::vector<Candidate>& pool, const std::vector<int>& ids, const std::vector<Layout>& layouts,
+              long long games, int threads) {
+    std::vector<std::pair<int, long long>> work;
+    for (int id : ids) {
+        auto& results = pool[id].results;
+        long long done = static_cast<long long>(results.size());
+        results.resize(games);
+        for (long long g = done; g < games; ++g) work.emplace_back(id, g);
+    }
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t i = next++; i < work.size(); i = next++) {
+            auto [id, g] = work[i];
+            pool[id].results[g] = playGame(layouts[g], nullptr, pool[id].params);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; ++t) workers.emplace_back(worker);
+    worker();
+    for (auto& w : workers) w.join();
+}
+
+void printInterval(const char* name, const Interval& interval) {
+    std::cout << "  " << std::left << std::setw(16) << name << std::right
+              << interval.value << "  [" << interval.low << ", " << interval.high << "]\n";
+}
+
+void printReport(const char* title, const Candidate& candidate, long long games, double lossPenalty) {
+    RunningStats movesToWin, scores;
+    std::uint64_t wins = 0;
+    for (long long i = 0; i < games; ++i) {
+        const auto& result = candidate.results[i];
+        scores.add(score(result, lossPenalty));
+        if (result.victory) {
+            wins++;
+            movesToWin.add(result.moves);
+        }
+    }
+    std::cout << title << " (" << games << " games, 95% CI):\n";
+    printInterval("moves to win", movesToWin.meanInterval());
+    printInterval("survival rate", wilsonInterval(wins, static_cast<std::uint64_t>(games)));
+    printInterval("score", scores.meanInterval());
+}
+
+void printParams(const AlgorithmParams& params) {
+    std::cout << "  lambdaMax       = " << params.lambdaMax << "\n"
+              << "  riskExponent    = " << params.riskExponent << "\n"
+              << "  neighborPenalty = " << params.neighborPenalty << "\n"
+              << "  shipFactor      = " << params.shipFactor << "\n"
+              << "  mineFactor      = " << params.mineFactor << "\n"
+              << "  mineThreshold   = " << params.mineThreshold << "\n"
+              << "  lowLives        = " << params.lowLives << "\n";
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string key = argv[i];
+        if (i + 1 >= argc) return false;
+        std::string value = argv[++i];
+        if (key == "--size") options.size = std::stoi(value);
+        else if (key == "--candidates") options.candidates = std::stoi(value);
+        else if (key == "--games") options.games = std::stoll(value);
+        else if (key == "--eta") options.eta = std::stoi(value);
+        else if (key == "--seed") options.seed = std::stoull(value);
+        else if (key == "--threads") options.threads = std::stoi(value);
+        else if (key == "--loss-penalty") options.lossPenalty = std::stod(value);
+        else if (key == "--holdout") options.holdout = std::stoll(value);
+        else return false;
+    }
+    return options.size >= 1 && options.candidates >= 1 && options.games >= 1 && options.games <= kMaxGames &&
+           options.eta >= 2 && options.threads >= 1 && options.holdout >= 0 && options.holdout <= kMaxGames;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        Options options;
+        if (!parseOptions(argc, argv, options)) {
+            std::cerr << "Usage: battleship_tune [--size N] [--candidates K] [--games G] [--eta E]\n"
+                      << "                       [--seed S] [--threads T] [--loss-penalty P] [--holdout H]\n";
+            return 1;
+        }
+        double lossPenalty = options.lossPenalty >= 0.0 ? options.lossPenalty
+                                                        : 2.0 * options.size * options.size;
+
+        std::mt19937_64 rng(options.seed);
+        std::vector<Candidate> pool(options.candidates);
+        for (int i = 1; i < options.candidates; ++i) pool[i].params = sampleParams(rng);
+
+        // Бюджет последнего раунда определяет, сколько расстановок нужно заранее
+        int rungs = 1;
+        for (long long alive = options.candidates; alive > 1; alive = (alive + options.eta - 1) / options.eta) rungs++;
+        long long maxGames = options.games;
+        for (int r = 1; r < rungs; ++r) {
+            // Проверка до умножения: бюджет растёт как E^раунды
+            if (maxGames > kMaxGames / options.eta) {
+                throw std::runtime_error("Final rung needs more than " + std::to_string(kMaxGames) +
+                                         " games; lower --games, --eta or --candidates");
+            }
+            maxGames *= options.eta;
+        }
+
+        // Расстановки отбора — seed + [0, maxGames), отложенные — следующие за ними
+        auto makeLayouts = [&](std::uint64_t firstSeed, long long count) {
+            std::vector<Layout> result(count);
+            for (long long g = 0; g < count; ++g) {
+                std::uint64_t seed = firstSeed + static_cast<std::uint64_t>(g);
+                if (!generateRandomLayout(options.size, seed, result[g])) {
+                    throw std::runtime_error("Cannot generate layout for seed " + std::to_string(seed));
+                }
+            }
+            return result;
+        };
+        std::vector<Layout> layouts = makeLayouts(options.seed, maxGames);
+
+        std::vector<int> alive(options.candidates);
+        for (int i = 0; i < options.candidates; ++i) alive[i] = i;
+        long long games = options.games;
+        for (int rung = 0;; ++rung) {
+            evaluate(pool, alive, layouts, games, options.threads);
+            std::stable_sort(alive.begin(), alive.end(), [&](int a, int b) {
+                return meanScore(pool[a], games, lossPenalty) < meanScore(pool[b], games, lossPenalty);
+            });
+            std::cout << "Rung " << rung << ": " << alive.size() << " candidates, " << games
+                      << " games, best score " << meanScore(pool[alive[0]], games, lossPenalty)
+                      << " (candidate " << alive[0] << ")\n";
+            if (alive.size() == 1) break;
+            alive.resize((alive.size() + options.eta - 1) / options.eta);
+            games *= options.eta;
+        }
+
+        // Оценка на партиях отбора смещена в пользу победителя — только для справки
+        evaluate(pool, {0}, layouts, games, options.threads);
+        std::cout << "\nSelection games (biased towards the winner): best score "
+                  << meanScore(pool[alive[0]], games, lossPenalty) << ", defaults "
+                  << meanScore(pool[0], games, lossPenalty) << "\n";
+
+        // Победитель и параметры по умолчанию заново на отложенных расстановках
+        long long holdout = options.holdout > 0 ? options.holdout : games;
+        std::vector<Layout> heldOut = makeLayouts(options.seed + static_cast<std::uint64_t>(maxGames), holdout);
+        std::vector<Candidate> finalists(2);
+        finalists[0].params = pool[alive[0]].params;
+        finalists[1].params = pool[0].params;
+        evaluate(finalists, {0, 1}, heldOut, holdout, options.threads);
+        const Candidate& best = finalists[0];
+        const Candidate& defaults = finalists[1];
+
+        std::cout << "\nBest parameters (candidate " << alive[0] << "):\n";
+        printParams(best.params);
+        std::cout << "\nHeld-out games, seeds " << options.seed + maxGames << ".."
+                  << options.seed + maxGames + holdout - 1 << ":\n";
+        printReport("Best", best, holdout, lossPenalty);
+        printReport("Defaults", defaults, holdout, lossPenalty);
+
+        RunningStats difference;
+        for (long long i = 0; i < holdout; ++i) {
+            difference.add(score(best.results[i], lossPenalty) - score(defaults.results[i], lossPenalty));
+        }
+        std::cout << "Paired score difference on held-out games, best - defaults:\n";
+        printInterval("score delta", difference.meanInterval());
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}